@@ -0,0 +1,64 @@
+#ifndef ASYNCSAVER_H
+#define ASYNCSAVER_H
+
+#include <TString.h>
+
+#include <vector>
+
+#include <sys/types.h>
+
+class TCanvas;
+class TFile;
+
+namespace RT
+{
+
+namespace Exports
+{
+
+/**
+ * Asynchronous variant of SaveAndClose(). The canvas is written to the TFile and closed in the
+ * calling thread; ExportImages() runs in a forked worker process on a serialized copy of the
+ * canvas, as in BatchExporter, so the caller can draw the next canvas meanwhile. ROOT graphics
+ * are not thread-safe, the worker has its own process. At most `capacity` workers run at once,
+ * saveAndClose() blocks when all are busy.
+ */
+class AsyncSaver
+{
+public:
+    AsyncSaver(size_t capacity = 8);
+    virtual ~AsyncSaver();
+
+    void saveAndClose(TCanvas* can, TFile* f, Bool_t export_images = kTRUE,
+                      const TString& path = "./");
+    void drain();
+
+    size_t pending();
+    inline size_t getCapacity() const { return capacity; }
+    inline size_t getFailed() const { return failed; }
+
+private:
+    AsyncSaver(const AsyncSaver&) = delete;
+    AsyncSaver& operator=(const AsyncSaver&) = delete;
+
+    struct Render
+    {
+        pid_t pid;
+        TString name;
+    };
+
+    void render(TCanvas* can, const TString& path);
+    void reap(Bool_t wait);
+
+protected:
+    size_t capacity;
+    size_t failed;
+
+    std::vector<Render> renders;
+};
+
+}; // namespace Exports
+
+}; // namespace RT
+
+#endif /* ASYNCSAVER_H */
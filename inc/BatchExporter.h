@@ -0,0 +1,58 @@
+#ifndef BATCHEXPORTER_H
+#define BATCHEXPORTER_H
+
+#include <TString.h>
+
+#include <vector>
+
+class TCanvas;
+
+namespace RT
+{
+
+namespace Exports
+{
+
+struct ExportResult
+{
+    TString name;
+    Bool_t ok;
+    TString message;
+};
+
+/**
+ * Renders many canvases with ExportImages() in a pool of forked worker processes. ROOT graphics
+ * are not thread-safe, but each worker has its own process. Canvases are serialized when added,
+ * so they can be closed or deleted by the caller right after.
+ */
+class BatchExporter
+{
+public:
+    BatchExporter(unsigned int workers = 0);
+
+    void add(TCanvas* can, const TString& path = "./");
+    auto run() -> std::vector<ExportResult>;
+
+    inline size_t size() const { return jobs.size(); }
+    inline unsigned int getWorkers() const { return workers; }
+
+private:
+    struct Job
+    {
+        TString name;
+        TString path;
+        std::vector<char> blob;
+    };
+
+    void work(unsigned int worker, unsigned int stride, int fd) const;
+
+protected:
+    std::vector<Job> jobs;
+    unsigned int workers;
+};
+
+}; // namespace Exports
+
+}; // namespace RT
+
+#endif /* BATCHEXPORTER_H */
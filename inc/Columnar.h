@@ -0,0 +1,66 @@
+#ifndef COLUMNAR_H
+#define COLUMNAR_H
+
+#include "HistCache.h"
+
+#include <TString.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TDirectory;
+class TH1;
+
+namespace RT
+{
+
+/**
+ * Columnar file of many histograms, meant for tools which do not read ROOT files. Each quantity
+ * of all histograms is stored in one contiguous array, in the native byte order of the writer:
+ *
+ *   header | index records | names and titles | edges | contents | sumw2
+ *
+ * An index record holds the dimension, bins and offsets of one histogram into the arrays; sumw2
+ * is the sum of squared weights (squared errors) of each bin. Bins include underflow and overflow
+ * in TH1 order. Contents are stored as double for any histogram type. Files are not converted
+ * between byte orders, so they are read on machines with the same one (little-endian on x86-64
+ * and most ARM systems).
+ */
+Bool_t WriteColumnar(const std::vector<TH1*>& hists, const TString& filename);
+Int_t WriteColumnar(TDirectory* dir, const TString& filename);
+
+/**
+ * Memory-mapped reader of the columnar files. The views point directly into the mapped file and
+ * are valid as long as the ColumnarFile object lives.
+ */
+class ColumnarFile
+{
+public:
+    ColumnarFile(const TString& filename);
+    virtual ~ColumnarFile();
+
+    inline Bool_t isOpen() const { return data != nullptr; }
+    inline size_t size() const { return views.size(); }
+
+    inline const HistView& view(size_t i) const { return views[i]; }
+    const HistView* find(const TString& name) const;
+
+    TH1* makeHistogram(const TString& name) const;
+    auto makeHistograms() const -> std::vector<TH1*>;
+
+private:
+    ColumnarFile(const ColumnarFile&) = delete;
+    ColumnarFile& operator=(const ColumnarFile&) = delete;
+
+protected:
+    void* data;
+    size_t data_size;
+
+    std::vector<HistView> views;
+    std::unordered_map<std::string, size_t> index;
+};
+
+}; // namespace RT
+
+#endif /* COLUMNAR_H */
@@ -0,0 +1,100 @@
+#ifndef COMPACTHIST_H
+#define COMPACTHIST_H
+
+#include <TString.h>
+
+#include <algorithm>
+#include <vector>
+
+class TH1;
+
+namespace RT
+{
+
+enum CompactPrecision
+{
+    CP_FLOAT,   // single precision, relative error below 2^-24 (6e-8)
+    CP_BLOCK16, // 16-bit integers with one scale per block, absolute error below max|v|/65534
+};
+
+/**
+ * Reduced-precision copy of a histogram (1D, 2D or 3D) for very large maps. Bin contents and bin
+ * errors are stored in blocks of block_size cells; blocks where all contents and errors are zero
+ * take no storage. With CP_FLOAT a histogram takes half of its TH*D size, with CP_BLOCK16 a
+ * quarter, less if it has empty blocks.
+ *
+ * In CP_BLOCK16 mode the bound max|v| is the largest absolute content (or error) within the same
+ * block, so small values next to large ones lose relative precision. Errors are stored rather than
+ * squared errors, which keeps the range narrow; the error of a histogram without Sumw2 is
+ * sqrt(|content|) as in TH1.
+ *
+ * The RT totals and error propagation functions below decode one block at a time, so no full copy
+ * of the histogram is made. As in the TH1 versions, under- and overflow bins are not used.
+ */
+class CompactHist
+{
+public:
+    static constexpr Int_t block_size = 4096;
+
+    CompactHist(const TH1* h, CompactPrecision precision = CP_FLOAT);
+
+    inline Int_t GetDimension() const { return dim; }
+    inline Int_t GetNbinsX() const { return nbins[0]; }
+    inline Int_t GetNbinsY() const { return nbins[1]; }
+    inline Int_t GetNbinsZ() const { return nbins[2]; }
+    inline Int_t GetNcells() const { return ncells; }
+    Int_t GetBin(Int_t x, Int_t y = 0, Int_t z = 0) const;
+
+    Double_t GetBinContent(Int_t bin) const;
+    Double_t GetBinError(Int_t bin) const;
+
+    inline const char* GetName() const { return name.Data(); }
+    inline CompactPrecision getPrecision() const { return precision; }
+    size_t getMemory() const;
+
+    void getTotals(Double_t& content, Double_t& error2, bool verbose = false) const;
+    void propagateErrorsMult(double val, double err);
+    void propagateErrorsDiv(double val, double err);
+
+    TH1* makeHistogram() const;
+
+private:
+    inline Int_t blockLength(size_t b) const
+    {
+        return std::min<Int_t>(block_size, ncells - b * block_size);
+    }
+
+    void decodeBlock(size_t b, Double_t* contents, Double_t* errors) const;
+    void encodeErrors(size_t b, const Double_t* errors);
+    template <class F> void forEachInRange(size_t b, F fn) const;
+    template <class F> void transformErrors(F fn);
+
+protected:
+    TString name;
+    TString title;
+    Int_t dim;
+    Int_t nbins[3];
+    Bool_t variable[3];
+    std::vector<Double_t> edges[3];
+    Double_t entries;
+    Bool_t has_sumw2;
+    CompactPrecision precision;
+    Int_t ncells;
+
+    std::vector<Long64_t> offsets; // per block, -1 for empty blocks; contents then errors
+    std::vector<Float_t> fdata;    // CP_FLOAT
+    std::vector<Short_t> qdata;    // CP_BLOCK16
+    std::vector<Double_t> scales;  // CP_BLOCK16, content and error scale per block
+};
+
+double calcTotalContent(const CompactHist& h, bool verbose = false);
+double calcTotalError(const CompactHist& h, bool verbose = false);
+void calcTotalHistogramValues(const CompactHist& h, double& content, double& error,
+                              bool verbose = false);
+
+void calcErrorPropagationMult(CompactHist& h, double val, double err);
+void calcErrorPropagationDiv(CompactHist& h, double val, double err);
+
+}; // namespace RT
+
+#endif /* COMPACTHIST_H */
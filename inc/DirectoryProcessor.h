@@ -0,0 +1,68 @@
+#ifndef DIRECTORYPROCESSOR_H
+#define DIRECTORYPROCESSOR_H
+
+#include <TString.h>
+
+#include <functional>
+#include <vector>
+
+class TDirectory;
+class TH1;
+
+namespace RT
+{
+
+struct ProcessSummary
+{
+    size_t visited;   // objects found in the source
+    size_t matched;   // histograms passing the filters
+    size_t processed; // written to the target
+    size_t failed;    // the operation returned nullptr
+
+    std::vector<TString> paths; // processed objects
+    std::vector<TString> errors; // failed objects
+
+    void print() const;
+};
+
+/**
+ * Applies an operation to every histogram of a directory (and its subdirectories) and writes the
+ * results into a target directory under the same relative path and name.
+ *
+ * The operation gets a private copy of each histogram; it returns the histogram to write, either
+ * the modified copy or a new histogram (the copy is then deleted), or nullptr on failure.
+ * Histograms are read and written by the calling thread in batches, the operations of a batch
+ * run in parallel, so they must not use global state (gPad, gDirectory, ...).
+ *
+ * The constructor enables ROOT thread safety for the whole process, see EnableThreadSafety().
+ */
+class DirectoryProcessor
+{
+public:
+    typedef std::function<TH1*(TH1* h, const TString& path)> Operation;
+
+    DirectoryProcessor(UInt_t workers = 0);
+
+    // wildcard pattern matched against the relative path, e.g. "sub/h_*"
+    inline void setPattern(const TString& p) { pattern = p; }
+    // only objects inheriting from this class
+    inline void setClass(const TString& c) { class_name = c; }
+
+    ProcessSummary run(TDirectory* source, TDirectory* target, const Operation& op) const;
+
+    inline UInt_t getWorkers() const { return workers; }
+
+    static Operation ErrorPropagationMult(double val, double err);
+    static Operation ErrorPropagationDiv(double val, double err);
+    static Operation RelativeErrorHistogram(bool percentage = false);
+    static Operation CopyRelativeErrors(TDirectory* errors_source);
+
+protected:
+    UInt_t workers;
+    TString pattern;
+    TString class_name;
+};
+
+}; // namespace RT
+
+#endif /* DIRECTORYPROCESSOR_H */
@@ -0,0 +1,43 @@
+#ifndef EFFICIENCY_H
+#define EFFICIENCY_H
+
+#include "RootTools.h"
+
+#include <vector>
+
+class TH1;
+
+namespace RT
+{
+
+enum EfficiencyInterval
+{
+    EI_NORMAL,          // normal approximation, sqrt(e(1-e)/N), clipped to [0, 1]
+    EI_WILSON,          // Wilson score interval
+    EI_CLOPPER_PEARSON, // exact interval from the beta distribution
+};
+
+/**
+ * Efficiencies pass/total of many bins in one pass over plain arrays, with low and high errors
+ * of the chosen interval at confidence level `cl` (default one sigma). Bins with total <= 0 get
+ * efficiency 0, and the full [0, 1] range as interval, except of the normal approximation which
+ * gives no error.
+ *
+ * With `workers` != 1 the bins are processed in chunks by a pool of threads, 0 for all CPUs.
+ */
+void CalcEfficiency(const Double_t* pass, const Double_t* total, size_t n, Double_t* eff,
+                    Double_t* err_low, Double_t* err_high, EfficiencyInterval interval = EI_NORMAL,
+                    Double_t cl = 0.682689492137, UInt_t workers = 1);
+
+/**
+ * Fills eff with the efficiencies of all cells of the pass and total histograms, which must have
+ * the same binning. TH1 errors are symmetric, the larger of the low and high error is set; the
+ * asymmetric errors can be returned in `errors`, one per cell.
+ */
+Bool_t CalcEfficiency(const TH1* pass, const TH1* total, TH1* eff,
+                      EfficiencyInterval interval = EI_NORMAL, Double_t cl = 0.682689492137,
+                      UInt_t workers = 1, std::vector<ErrorsPair>* errors = nullptr);
+
+}; // namespace RT
+
+#endif /* EFFICIENCY_H */
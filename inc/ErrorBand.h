@@ -0,0 +1,58 @@
+#ifndef ERRORBAND_H
+#define ERRORBAND_H
+
+#include <TMatrixDSym.h>
+
+#include <utility>
+#include <vector>
+
+class TF1;
+
+namespace RT
+{
+
+/**
+ * Uncertainty band of a fitted function from the covariance matrix of its parameters, by linear
+ * error propagation: sigma^2(x) = g(x)^T C g(x), where g is the gradient of f(x) with respect to
+ * the parameters, evaluated with central differences. The integral and its error are propagated
+ * the same way with the gradient integrated over the range.
+ *
+ * The function is evaluated with TF1::EvalPar() on private parameter arrays, so neither the
+ * function nor its parameters are modified and no copies of it are made. Parameters with zero
+ * variance (e.g. fixed ones) do not contribute. The same object can be reused for many fits of
+ * one function by calling setCovariance() after each fit.
+ */
+class ErrorBand
+{
+public:
+    ErrorBand(TF1* f);
+    ErrorBand(TF1* f, const TMatrixDSym& cov);
+
+    void setCovariance();
+    void setCovariance(const TMatrixDSym& cov);
+
+    void band(const Double_t* x, size_t n, Double_t* value, Double_t* error);
+    void band(Double_t xmin, Double_t xmax, size_t n, Double_t* x, Double_t* value,
+              Double_t* error);
+
+    std::pair<double, double> integral(Double_t l, Double_t u, Int_t nintervals = 100);
+
+    inline TF1* getFunction() const { return func; }
+
+private:
+    Double_t evalGradient(Double_t x, Double_t* grad);
+    Double_t propagate(const Double_t* grad) const;
+
+protected:
+    TF1* func;
+    Int_t npar;
+    std::vector<Double_t> cov;   // npar x npar, row-major
+    std::vector<Double_t> steps; // difference steps, 0 for parameters without variance
+    std::vector<Double_t> pars;  // scratch
+    std::vector<Double_t> grad;  // scratch
+    std::vector<Double_t> igrad; // scratch
+};
+
+}; // namespace RT
+
+#endif /* ERRORBAND_H */
@@ -0,0 +1,59 @@
+#ifndef EXPORTCACHE_H
+#define EXPORTCACHE_H
+
+#include <TString.h>
+
+#include <map>
+#include <string>
+
+class TCanvas;
+
+namespace RT
+{
+
+namespace Exports
+{
+
+/**
+ * Skips ExportImages() for canvases which did not change since the last export. The digest of
+ * each exported canvas is stored in a manifest file in the export directory; a canvas is rendered
+ * again only if its digest differs or one of the exported files is missing.
+ *
+ * The digest covers the streamed canvas (all primitives with their contents and attributes), the
+ * current gStyle and the enabled image formats.
+ */
+class ExportCache
+{
+public:
+    ExportCache(const TString& path = "./");
+    virtual ~ExportCache();
+
+    Bool_t exportImages(TCanvas* can);
+    void save();
+
+    static ULong64_t digest(TCanvas* can);
+
+    inline const TString& getPath() const { return path; }
+    inline size_t getExported() const { return cnt_exported; }
+    inline size_t getSkipped() const { return cnt_skipped; }
+
+    static const char* manifest_name;
+
+private:
+    void load();
+    Bool_t filesExist(TCanvas* can) const;
+
+protected:
+    TString path;
+    std::map<std::string, ULong64_t> entries;
+    bool modified;
+
+    size_t cnt_exported;
+    size_t cnt_skipped;
+};
+
+}; // namespace Exports
+
+}; // namespace RT
+
+#endif /* EXPORTCACHE_H */
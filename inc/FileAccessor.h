@@ -0,0 +1,104 @@
+#ifndef FILEACCESSOR_H
+#define FILEACCESSOR_H
+
+#include <TString.h>
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TDirectory;
+class TFile;
+class TKey;
+class TObject;
+
+namespace RT
+{
+
+/**
+ * Indexed access to objects stored in a ROOT file. The keys of the file and of all its
+ * subdirectories are indexed once at construction, names of objects in subdirectories are
+ * "dir/name". Read objects are cached and owned by the accessor; the least recently used ones are
+ * deleted when the cache grows above the memory budget (estimated from the uncompressed size of
+ * the keys). Histograms are detached from the file.
+ *
+ * Missing objects are reported with nullptr, the process is never terminated. A returned object
+ * stays valid until a later get() evicts it; Clone() objects which must outlive the cache.
+ */
+class FileAccessor
+{
+public:
+    struct KeyInfo
+    {
+        TString name;
+        TString class_name;
+        size_t size;
+    };
+
+    FileAccessor(TFile* f, size_t budget = 256 * 1024 * 1024);
+    FileAccessor(const TString& filename, size_t budget = 256 * 1024 * 1024);
+    virtual ~FileAccessor();
+
+    Bool_t has(const TString& name) const;
+
+    TObject* get(const TString& name);
+    template <class T> T* get(const TString& name) { return dynamic_cast<T*>(get(name)); }
+    size_t get(const std::vector<TString>& names, std::vector<TObject*>& objects);
+
+    void clear();
+
+    inline Bool_t isOpen() const { return file != nullptr; }
+    inline TFile* getFile() const { return file; }
+    inline size_t getKeys() const { return index.size(); }
+    auto getIndex() const -> std::vector<KeyInfo>;
+
+    void setBudget(size_t b);
+    inline size_t getBudget() const { return budget; }
+    inline size_t getMemory() const { return memory; }
+
+    inline size_t getHits() const { return cnt_hits; }
+    inline size_t getReads() const { return cnt_reads; }
+    inline size_t getRequests() const { return cnt_requests; }
+
+    // reads are merged when the gap between two keys is not larger than this
+    static size_t coalesce_gap;
+    // and as long as the merged request is not larger than this
+    static size_t coalesce_max;
+
+private:
+    struct Entry
+    {
+        TKey* key;
+        TObject* obj;
+        size_t size;
+        size_t batch;
+        std::list<Entry*>::iterator lru;
+    };
+
+    void buildIndex(TDirectory* dir, const TString& prefix);
+    Entry* find(const TString& name);
+    void readBatch(std::vector<Entry*>& entries);
+    void store(Entry* e, TObject* obj);
+    void touch(Entry* e);
+    void evict();
+
+protected:
+    TFile* file;
+    bool owner;
+
+    std::unordered_map<std::string, Entry> index;
+    std::list<Entry*> lru;
+
+    size_t budget;
+    size_t memory;
+    size_t batch;
+
+    size_t cnt_hits;
+    size_t cnt_reads;
+    size_t cnt_requests;
+};
+
+}; // namespace RT
+
+#endif /* FILEACCESSOR_H */
@@ -0,0 +1,90 @@
+#ifndef FITPIPELINE_H
+#define FITPIPELINE_H
+
+#include <TString.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class TF1;
+class TH1;
+
+namespace RT
+{
+
+struct SliceFit
+{
+    TH1* hist;       // not owned
+    double integral; // of the histogram, taken by run()
+    Int_t ix;        // slice position, e.g. pT bin
+    Int_t iy;        // slice position, e.g. rapidity bin
+    bool fitted;     // fit was run
+    Int_t status;    // fit status, 0 for converged
+    long seed;       // slice whose parameters started the fit, -1 for the model
+
+    std::vector<double> params;
+    std::vector<double> errors;
+    double chi2;
+    Int_t ndf;
+
+    bool has_info; // mean and width are known, see calcFitInfo()
+    double mean;
+    double width;
+};
+
+/**
+ * Fits one model to many slices of a differential spectrum (e.g. mass spectra in pT-y bins). The
+ * slices are placed on a grid; a fit starts from the converged parameters of a neighbouring slice
+ * (sharing an edge on the grid) instead of from the model.
+ *
+ * The fits run in waves: the first wave is the slice with the most entries, started from the
+ * model; each next wave holds all slices with a converged neighbour and runs on the thread pool.
+ * If no slice has a converged neighbour, the largest remaining one is started from the model. A
+ * failed warm-started fit is repeated from the model. The waves depend only on the fit results,
+ * so the results are the same for any number of threads.
+ *
+ * Mean and width of the signal are taken with calcFitInfo() from the signal function set with
+ * setSignal(), which gets its parameters from the fitted model. calcFitInfo() knows the signal
+ * shapes only by the function title, e.g. "voigt" or "ggaus", and a signal plus background model
+ * is none of them; without setSignal() the model itself is used and has_info stays false for
+ * such models.
+ * Nothing is drawn. The slices are fitted with Minuit2, which can fit in parallel, set per fit
+ * with FitWithMinimizer(); the process-wide default minimizer is not changed. The constructor
+ * enables ROOT thread safety for the whole process, see EnableThreadSafety().
+ */
+class FitPipeline
+{
+public:
+    FitPipeline(const TF1* model, UInt_t workers = 0);
+
+    size_t addSlice(TH1* h, Int_t ix, Int_t iy = 0);
+
+    bool setSignal(const TF1* sig, Int_t offset = 0);
+    inline void setFitOptions(const TString& opts) { fit_options = opts; }
+
+    size_t run();
+
+    inline size_t size() const { return slices.size(); }
+    inline const SliceFit& getSlice(size_t i) const { return slices[i]; }
+    inline UInt_t getWorkers() const { return workers; }
+    inline size_t getWaves() const { return waves; }
+
+private:
+    long bestNeighbour(size_t i) const;
+
+protected:
+    const TF1* model;
+    const TF1* signal;
+    Int_t signal_offset;
+    UInt_t workers;
+    TString fit_options;
+    size_t waves;
+
+    std::vector<SliceFit> slices;
+    std::map<std::pair<Int_t, Int_t>, size_t> grid;
+};
+
+}; // namespace RT
+
+#endif /* FITPIPELINE_H */
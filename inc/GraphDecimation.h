@@ -0,0 +1,31 @@
+#ifndef GRAPHDECIMATION_H
+#define GRAPHDECIMATION_H
+
+#include <Rtypes.h>
+
+class TGraph;
+class TVirtualPad;
+
+namespace RT
+{
+
+enum DecimationMode
+{
+    DM_MINMAX, // first, last, lowest and highest point of each column, also with error bars
+    DM_LTTB,   // Largest-Triangle-Three-Buckets
+};
+
+/**
+ * Reduces number of points of huge graphs before drawing or vector export. The decimated graph is
+ * a new object of the same kind (TGraph, TGraphErrors or TGraphAsymmErrors) with the attributes of
+ * the source graph. Points with the lowest and highest value, with and without error bars, are
+ * always kept, so FindBoundaries() gives the same result for both graphs. DM_LTTB assumes points
+ * sorted in x. With log x, points at x <= 0 are kept as they are.
+ */
+TGraph* DecimateGraph(const TGraph* gr, UInt_t columns, DecimationMode mode = DM_MINMAX,
+                      Bool_t logx = kFALSE);
+TGraph* DecimateGraph(const TGraph* gr, TVirtualPad* pad, DecimationMode mode = DM_MINMAX);
+
+}; // namespace RT
+
+#endif /* GRAPHDECIMATION_H */
@@ -0,0 +1,119 @@
+#ifndef HISTACCUMULATOR_H
+#define HISTACCUMULATOR_H
+
+#include <TH2.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace RT
+{
+
+/**
+ * Fills one histogram from many threads without locks. Each thread fills its own slot, a private
+ * copy of the model histogram; merge() adds the copies with a pairwise tree reduction.
+ *
+ * A thread takes a slot with acquire() once and passes it to every fill. With a non-zero
+ * buffer_size the fills of a slot are queued and passed to FillN in blocks, otherwise the slot
+ * histogram is filled directly. The slots and their fill buffers are allocated on cache lines of
+ * their own, so the state written on every fill is never shared by two threads. The slot
+ * histograms are allocated by ROOT and may share cache lines; with a buffer they are written only
+ * once per block. A thread calling acquire() when all slots are taken gets the shared overflow
+ * slot, whose fills are serialized by a mutex and not buffered.
+ *
+ * The constructor enables ROOT thread safety for the whole process, see EnableThreadSafety().
+ */
+class HistAccumulator
+{
+public:
+    HistAccumulator(const TH1* model, UInt_t slots = 0, size_t buffer_size = 0);
+    virtual ~HistAccumulator();
+
+    UInt_t acquire();
+
+    // fill of a 1D histogram
+    inline void fill(UInt_t slot, Double_t x, Double_t w = 1.0)
+    {
+        if (slot >= nslots)
+        {
+            fillOverflow(x, 0.0, w, false);
+            return;
+        }
+
+        Slot& s = slots[slot];
+        if (!buffer_size)
+        {
+            s.h->Fill(x, w);
+            return;
+        }
+
+        queue(s, x, 0.0, w);
+    }
+
+    // fill of a 2D histogram
+    inline void fillXY(UInt_t slot, Double_t x, Double_t y, Double_t w = 1.0)
+    {
+        if (slot >= nslots)
+        {
+            fillOverflow(x, y, w, true);
+            return;
+        }
+
+        Slot& s = slots[slot];
+        if (!buffer_size)
+        {
+            ((TH2*)s.h)->Fill(x, y, w);
+            return;
+        }
+
+        queue(s, x, y, w);
+    }
+
+    // slot histogram, pending fills of a buffered slot are not included
+    inline TH1* local(UInt_t slot) const
+    {
+        return slot < nslots ? slots[slot].h : overflow;
+    }
+    inline UInt_t getSlots() const { return nslots; }
+
+    TH1* merge();
+
+private:
+    HistAccumulator(const HistAccumulator&) = delete;
+    HistAccumulator& operator=(const HistAccumulator&) = delete;
+
+    // one cache line, the array of slots is aligned to cache lines
+    struct alignas(64) Slot
+    {
+        TH1* h;
+        Double_t* buffer; // queued fills as x,y,w, on cache lines of its own
+        size_t queued;    // number of queued values
+    };
+
+    inline void queue(Slot& s, Double_t x, Double_t y, Double_t w)
+    {
+        Double_t* b = s.buffer + s.queued;
+        b[0] = x;
+        b[1] = y;
+        b[2] = w;
+        s.queued += 3;
+        if (s.queued >= 3 * buffer_size) flush(s);
+    }
+    void flush(Slot& s);
+    void fillOverflow(Double_t x, Double_t y, Double_t w, bool xy);
+
+protected:
+    TH1* model;
+    Slot* slots;        // allocated with the cache line alignment, also before C++17
+    UInt_t nslots;
+    Double_t* buffers;  // fill buffers of all slots
+    size_t buffer_size; // fills queued per slot, 0 for direct filling
+    std::atomic<UInt_t> next_slot;
+
+    TH1* overflow; // shared by the threads beyond the slots
+    std::mutex overflow_mtx;
+};
+
+}; // namespace RT
+
+#endif /* HISTACCUMULATOR_H */
@@ -0,0 +1,95 @@
+#ifndef HISTCACHE_H
+#define HISTCACHE_H
+
+#include <TString.h>
+
+#include <cmath>
+
+class TFile;
+class TH1;
+
+namespace RT
+{
+
+/**
+ * Read-only view of the bins of a histogram, with the same bin numbering as TH1 (underflow and
+ * overflow included). The arrays are not owned by the view.
+ */
+struct HistView
+{
+    Int_t dim;
+    Int_t nbins[3];
+    Bool_t variable[3];
+    const Double_t* edges[3];
+    const Double_t* contents;
+    const Double_t* sumw2;
+    Double_t entries;
+    const char* name;
+    const char* title;
+
+    inline Int_t GetNbinsX() const { return nbins[0]; }
+    inline Int_t GetNbinsY() const { return nbins[1]; }
+    inline Int_t GetNbinsZ() const { return nbins[2]; }
+    // axes above the dimension have no under- and overflow, as in TH1
+    inline Int_t GetNcells() const
+    {
+        return (nbins[0] + 2) * (dim > 1 ? nbins[1] + 2 : 1) * (dim > 2 ? nbins[2] + 2 : 1);
+    }
+
+    inline Int_t GetBin(Int_t x, Int_t y = 0, Int_t z = 0) const
+    {
+        if (dim < 2) return x;
+        if (dim < 3) return x + (nbins[0] + 2) * y;
+        return x + (nbins[0] + 2) * (y + (nbins[1] + 2) * z);
+    }
+
+    inline Double_t GetBinContent(Int_t bin) const { return contents[bin]; }
+    inline Double_t GetBinContent(Int_t x, Int_t y) const { return contents[GetBin(x, y)]; }
+    inline Double_t GetBinError(Int_t bin) const
+    {
+        return sumw2 ? sqrt(sumw2[bin]) : sqrt(fabs(contents[bin]));
+    }
+    inline Double_t GetBinError(Int_t x, Int_t y) const { return GetBinError(GetBin(x, y)); }
+};
+
+/**
+ * Creates a histogram (TH1D, TH2D or TH3D) with a copy of the view bins, owned by the caller and
+ * not attached to a directory. The bins are left empty if the view has no contents.
+ */
+TH1* MakeHistogram(const HistView& v);
+
+/**
+ * Binary cache of a single histogram: axis edges, bin contents and Sumw2 stored as plain double
+ * arrays which are memory-mapped on load, so no decompression or streaming is needed. A cache is
+ * valid only if it was not modified before its source file, compared with nanosecond resolution.
+ *
+ * The view() points directly into the mapped file and is valid as long as the HistCache object
+ * lives; makeHistogram() copies the bins into a new TH1D, TH2D or TH3D.
+ */
+class HistCache
+{
+public:
+    HistCache(const TString& cache_file, const char* source = nullptr);
+    virtual ~HistCache();
+
+    inline Bool_t isValid() const { return data != nullptr; }
+    inline const HistView& view() const { return hview; }
+
+    TH1* makeHistogram() const;
+
+    static Bool_t write(const TH1* h, const TString& cache_file);
+    static TH1* fetch(TFile* f, const TString& name, const TString& cache_file);
+
+private:
+    HistCache(const HistCache&) = delete;
+    HistCache& operator=(const HistCache&) = delete;
+
+protected:
+    void* data;
+    size_t size;
+    HistView hview;
+};
+
+}; // namespace RT
+
+#endif /* HISTCACHE_H */
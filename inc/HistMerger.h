@@ -0,0 +1,69 @@
+#ifndef HISTMERGER_H
+#define HISTMERGER_H
+
+#include <TString.h>
+
+#include <vector>
+
+class TObject;
+
+namespace RT
+{
+
+class FileAccessor;
+
+/**
+ * Sums the histograms of many ROOT files into one output file. Histogram keys are taken from
+ * the first input, including subdirectories; other objects are not merged.
+ *
+ * The keys are processed in chunks which fit into the memory budget. For each chunk the inputs
+ * are shared by a pool of threads, each thread reads its files with a FileAccessor (coalesced
+ * reads in file order) and sums them into a partial result. The partial results are combined with
+ * a parallel tree reduction and the chunk is written to the output before the next one is read.
+ * Each input is opened and indexed once per merge() and stays open until it ends, so the limit of
+ * open files must allow for all inputs.
+ *
+ * The constructor enables ROOT thread safety for the whole process, see EnableThreadSafety().
+ */
+class HistMerger
+{
+public:
+    HistMerger(UInt_t workers = 0, size_t budget = 512 * 1024 * 1024);
+
+    void add(const TString& filename);
+    void add(const std::vector<TString>& filenames);
+
+    Int_t merge(const TString& output);
+
+    inline size_t size() const { return inputs.size(); }
+    inline UInt_t getWorkers() const { return workers; }
+    inline size_t getBudget() const { return budget; }
+
+    inline size_t getMissing() const { return cnt_missing; }
+    inline size_t getFailed() const { return cnt_failed; }
+
+private:
+    struct Partial
+    {
+        std::vector<TObject*> objects;
+        size_t missing;
+        size_t failed;
+    };
+
+    void mergeRange(const std::vector<TString>& names, size_t first, size_t last,
+                    std::vector<FileAccessor*>& accessors, Partial& partial);
+    void reduce(std::vector<Partial>& partials);
+
+protected:
+    UInt_t workers;
+    size_t budget;
+
+    std::vector<TString> inputs;
+
+    size_t cnt_missing;
+    size_t cnt_failed;
+};
+
+}; // namespace RT
+
+#endif /* HISTMERGER_H */
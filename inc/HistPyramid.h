@@ -0,0 +1,45 @@
+#ifndef HISTPYRAMID_H
+#define HISTPYRAMID_H
+
+#include <TH2.h>
+
+#include <vector>
+
+class TVirtualPad;
+
+namespace RT
+{
+
+/**
+ * Multi-resolution representation of a large TH2. Each level merges 2x2 bins of the previous one,
+ * contents and squared errors are summed in the same pass. Level 0 is the original histogram,
+ * which is not owned by the pyramid; coarser levels are owned TH2D.
+ *
+ * selectLevel() picks the coarsest level which has still at least as many bins as the output has
+ * pixels, so drawing or exporting costs depend on the output size rather than on the bin count.
+ */
+class HistPyramid
+{
+public:
+    HistPyramid(TH2* h, Int_t min_bins = 64);
+    virtual ~HistPyramid();
+
+    inline size_t getLevels() const { return levels.size(); }
+    inline TH2* getLevel(size_t l) const { return levels[l]; }
+
+    TH2* selectLevel(UInt_t px_x, UInt_t px_y) const;
+    TH2* selectLevel(TVirtualPad* pad) const;
+
+private:
+    HistPyramid(const HistPyramid&) = delete;
+    HistPyramid& operator=(const HistPyramid&) = delete;
+
+    TH2D* makeLevel(const TH2* prev, Int_t level) const;
+
+protected:
+    std::vector<TH2*> levels;
+};
+
+}; // namespace RT
+
+#endif /* HISTPYRAMID_H */
@@ -0,0 +1,59 @@
+#ifndef INTEGRALCACHE_H
+#define INTEGRALCACHE_H
+
+#include <Rtypes.h>
+
+#include <utility>
+#include <vector>
+
+class TF1;
+
+namespace RT
+{
+
+/**
+ * Table of the cumulative integral of a TF1 over its range, for functions integrated many times
+ * over different ranges. The range is split into npoints equal intervals, each integrated with a
+ * 5-point Gauss-Legendre rule; between the nodes the cumulative integral is interpolated with a
+ * cubic Hermite polynomial which uses the function values as derivatives.
+ *
+ * The table is rebuilt on the next integral() call when the parameters or the range of the
+ * function change. Ranges outside of the function range are passed to TF1::Integral().
+ *
+ * For smooth functions the interpolation error is of order h^4 max|f'''| / 384 for an interval
+ * width h; functions with sharp features need more points.
+ */
+class IntegralCache
+{
+public:
+    IntegralCache(TF1* f, Int_t npoints = 1000);
+
+    Double_t integral(Double_t l, Double_t u);
+
+    inline TF1* getFunction() const { return func; }
+    inline Int_t getPoints() const { return npoints; }
+    inline size_t getBuilds() const { return builds; }
+
+private:
+    Bool_t isValid() const;
+    void build();
+    Double_t cumulative(Double_t x) const;
+
+protected:
+    TF1* func;
+    Int_t npoints;
+    size_t builds;
+
+    Double_t xmin;
+    Double_t xmax;
+    std::vector<Double_t> params; // parameters of the table
+    std::vector<Double_t> cdf;    // integral from xmin to each node
+    std::vector<Double_t> values; // function value at each node
+};
+
+std::pair<double, double> calcSubstractionError(IntegralCache& total, IntegralCache& bkg,
+                                                double l, double u, bool verbose = false);
+
+}; // namespace RT
+
+#endif /* INTEGRALCACHE_H */
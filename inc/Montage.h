@@ -0,0 +1,34 @@
+#ifndef MONTAGE_H
+#define MONTAGE_H
+
+#include <TString.h>
+
+#include <vector>
+
+class TASImage;
+class TCanvas;
+
+namespace RT
+{
+
+namespace Exports
+{
+
+/**
+ * Composes many canvases into one image atlas of width x height pixels, tiles are placed in rows
+ * of `columns` tiles. Each canvas is rendered once directly at the tile resolution; with more than
+ * one worker the tiles are rendered by forked processes into a shared buffer. The atlas is written
+ * in one go, the image format follows the file extension.
+ *
+ * @return number of tiles which could not be rendered, -1 if the atlas was not written
+ */
+Int_t ExportMontage(const std::vector<TCanvas*>& canvases, const TString& filename,
+                    UInt_t columns, UInt_t width, UInt_t height, UInt_t workers = 0);
+Int_t ExportMontage(const std::vector<TASImage*>& images, const TString& filename, UInt_t columns,
+                    UInt_t width, UInt_t height);
+
+} // namespace Exports
+
+}; // namespace RT
+
+#endif /* MONTAGE_H */
@@ -0,0 +1,61 @@
+#ifndef PAGEEXPORTER_H
+#define PAGEEXPORTER_H
+
+#include <TString.h>
+
+#include <vector>
+
+class TCanvas;
+
+namespace RT
+{
+
+namespace Exports
+{
+
+/**
+ * Streams many canvases as pages into a single multi-page PDF or PS file. The file is opened by
+ * the constructor and closed by close() or the destructor. Each page gets an outline entry with
+ * its title (PDF), and writeIndex() produces a table of contents of the pages.
+ *
+ * The pages go through the global gVirtualPS of ROOT, so only one PageExporter can be open at a
+ * time; a second one is not opened (isOpen() is false) until the first is closed.
+ */
+class PageExporter
+{
+public:
+    PageExporter(const TString& filename);
+    virtual ~PageExporter();
+
+    void addPage(TCanvas* can, const TString& title = "");
+    void close();
+
+    Bool_t writeIndex(const TString& filename) const;
+
+    inline const TString& getFilename() const { return filename; }
+    inline size_t getPages() const { return pages.size(); }
+    inline Bool_t isOpen() const { return canvas != nullptr; }
+
+private:
+    PageExporter(const PageExporter&) = delete;
+    PageExporter& operator=(const PageExporter&) = delete;
+
+    struct Page
+    {
+        TString name;
+        TString title;
+    };
+
+protected:
+    TString filename;
+    TCanvas* canvas; // only opens and closes the stream
+    std::vector<Page> pages;
+
+    static PageExporter* current; // the open exporter
+};
+
+}; // namespace Exports
+
+}; // namespace RT
+
+#endif /* PAGEEXPORTER_H */
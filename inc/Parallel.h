@@ -0,0 +1,32 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <Rtypes.h>
+
+#include <functional>
+
+namespace RT
+{
+
+/**
+ * Number of workers to use, 0 means one per online CPU.
+ */
+UInt_t GetWorkers(UInt_t workers = 0);
+
+/**
+ * Enables ROOT thread safety for the whole process, ROOT::EnableThreadSafety() on ROOT 6 and
+ * TThread::Initialize() on ROOT 5. It can not be disabled again; classes which run ROOT code in
+ * threads call it from their constructors.
+ */
+void EnableThreadSafety();
+
+/**
+ * Calls fn(i) for i in [0, n) using `workers` threads (0 for all CPUs). Indices are handed out
+ * one by one, so uneven tasks are balanced. With one worker, or a single task, everything runs in
+ * the calling thread. Returns when all tasks are done.
+ */
+void ParallelFor(size_t n, UInt_t workers, const std::function<void(size_t)>& fn);
+
+}; // namespace RT
+
+#endif /* PARALLEL_H */
@@ -17,12 +17,22 @@ class TVirtualPad;
 namespace RT
 {
 
+class HistPyramid;
+struct HistView;
+class SparseBins;
+
 struct ErrorsPair
 {
     double high;
     double low;
 };
 
+struct ErrorsParseIssue
+{
+    size_t section;  // index of the malformed section
+    size_t position; // offset of the first malformed character in the input
+};
+
 enum StatFlags
 {
     SF_COUNTS = 0x01,
@@ -135,12 +145,31 @@ void ExportImages(TCanvas* can, const TString& path = "./");
 
 void SaveAndClose(TCanvas* can, TFile* f, Bool_t export_images = kTRUE, const TString& path = "./");
 
+// Canvas snapshots, e.g. to render them outside of the current process or thread
+auto SerializeCanvas(TCanvas* can) -> std::vector<char>;
+TCanvas* DeserializeCanvas(const char* data, size_t size);
+
 } // namespace Exports
 
 // Pt and Momentum functions
 Double_t MtY(Double_t* yP, Double_t* par);
 Double_t Momentum(Double_t* yP, Double_t* par);
 
+namespace Palettes
+{
+
+/**
+ * Gradient palettes are created once and then reused by their index. Creating a palette with the
+ * same definition again returns the already allocated one instead of allocating new TColors.
+ */
+Int_t Create(UInt_t nstops, const Double_t* stops, const Double_t* red, const Double_t* green,
+             const Double_t* blue, UInt_t ncont, Float_t alpha = 1.0);
+Bool_t Use(Int_t id);
+Int_t GetNColors(Int_t id);
+const Int_t* GetColors(Int_t id);
+
+} // namespace Palettes
+
 TPaletteAxis* NicePalette(TH2* h, Float_t ls, Float_t ts = 0, Float_t to = 0);
 TPaletteAxis* NoPalette(TH2* h);
 
@@ -148,10 +177,13 @@ void AutoScale(TH1* hdraw, TH1* href, Bool_t MinOnZero = kTRUE);
 void AutoScaleF(TH1* hdraw, TH1* href);
 void AutoScale(TH1* hdraw, TH1* href1, TH1* href2);
 
+std::pair<double, double> calcSubstractionError(double int_t, double int_b, bool verbose = false);
 std::pair<double, double> calcSubstractionError(TF1* total, TF1* bkg, double l, double u,
                                                 bool verbose = false);
 double calcTotalError(TH1* h, Int_t bin_l, Int_t bin_u);
+double calcTotalError(const HistView& h, Int_t bin_l, Int_t bin_u);
 double calcTotalError2(TH1* h, Int_t bin_l, Int_t bin_u);
+double calcTotalError2(const HistView& h, Int_t bin_l, Int_t bin_u);
 
 TNamed* GetObjectFromFile(TFile* f, const TString& hname, const TString& suffix = "");
 
@@ -162,6 +194,10 @@ Int_t FindEqualIntegralRange(TH1* hist, Float_t integral, Int_t starting_bin, In
                              Bool_t equal_or_bigger = kTRUE);
 
 void QuickDraw(TVirtualPad* p, TH1* h, const char* opts = "", UChar_t logbits = 0);
+void QuickDraw(TVirtualPad* p, const HistPyramid& pyramid, const char* opts = "",
+               UChar_t logbits = 0);
+void QuickDraw(TVirtualPad* p, TGraph* gr, const char* opts = "AP", UChar_t logbits = 0,
+               Bool_t decimate = kFALSE);
 void DrawStats(TVirtualPad* p, TH1* h, UInt_t flags = SF_COUNTS, Float_t x = 0.65, Float_t y = 0.85,
                Float_t dy = -0.05);
 
@@ -169,8 +205,12 @@ bool FindMaxRange(float& range, const TH1* hist);
 bool FindMaxRange(float& range, float& cand);
 
 void MyMath();
+bool calcFitInfo(const TF1* fun, double& mean, double& width);
 void FetchFitInfo(TF1* fun, double& mean, double& width, double& sig, double& bkg,
                   TPad* pad = nullptr);
+bool HasMinimizer(const char* type);
+Int_t FitWithMinimizer(TH1* h, TF1* f, const char* options, const char* type,
+                       const char* algo = "Migrad");
 
 bool Smooth(TH1* h);
 bool Smooth(TH1* h, int loops);
@@ -199,21 +239,42 @@ double calcFuncErrorBar(TF1* fun, double x1, double x2, double bar_width_scale =
                         int ccolor = 0);
 
 void copyRelativeErrors(TH1* destination, TH1* source);
+void copyRelativeErrors(TH1* destination, TH1* source, const SparseBins& bins);
 void calcBinomialErrors(TH1* p, TH1* N);
+void calcBinomialErrors(TH1* p, TH1* N, const SparseBins& bins);
 void calcBinomialErrors(TH1* p, TH1* q, TH1* N);
+void calcBinomialErrors(TH1* p, TH1* q, TH1* N, const SparseBins& bins);
 
 void calcErrorPropagationMult(TH1* h, double val, double err);
+void calcErrorPropagationMult(TH1* h, const SparseBins& bins, double val, double err);
 void calcErrorPropagationDiv(TH1* h, double val, double err);
-auto errorsStrToArray(const std::string& errors_str) -> std::vector<ErrorsPair>;
+void calcErrorPropagationDiv(TH1* h, const SparseBins& bins, double val, double err);
+auto errorsStrToArray(const std::string& errors_str,
+                      std::vector<ErrorsParseIssue>* issues = nullptr) -> std::vector<ErrorsPair>;
+size_t errorsStrToArray(const std::string& errors_str, ErrorsPair* buffer, size_t capacity,
+                        std::vector<ErrorsParseIssue>* issues = nullptr);
+size_t errorsStrToArray(const char* errors_str, size_t length, ErrorsPair* buffer, size_t capacity,
+                        std::vector<ErrorsParseIssue>* issues = nullptr);
+size_t errorsFileToArray(const char* filename, ErrorsPair* buffer, size_t capacity,
+                         std::vector<ErrorsParseIssue>* issues = nullptr);
 
 double calcTotalContent(TH1* h, bool verbose = false);
+double calcTotalContent(const HistView& h, bool verbose = false);
+double calcTotalContent(TH1* h, const SparseBins& bins, bool verbose = false);
 
 double calcTotalError(TH1* h, bool verbose = false);
+double calcTotalError(const HistView& h, bool verbose = false);
+double calcTotalError(TH1* h, const SparseBins& bins, bool verbose = false);
 double calcTotalError(const std::vector<ErrorsPair>& errschain, double& err_u, double& err_l);
 
 void calcTotalHistogramValues(TH1* h, double& content, double& error, bool verbose = false);
+void calcTotalHistogramValues(const HistView& h, double& content, double& error,
+                              bool verbose = false);
+void calcTotalHistogramValues(TH1* h, const SparseBins& bins, double& content, double& error,
+                              bool verbose = false);
 
 TH1* makeRelativeErrorHistogram(TH1* h, bool percentage = false);
+TH1* makeRelativeErrorHistogram(TH1* h, const SparseBins& bins, bool percentage = false);
 }; // namespace RT
 
 Double_t langaufun(Double_t* x, Double_t* par);
@@ -0,0 +1,63 @@
+#ifndef SPARSEBINS_H
+#define SPARSEBINS_H
+
+#include <TH2.h>
+
+#include <vector>
+
+namespace RT
+{
+
+/**
+ * List of the non-empty bins of a 1D or 2D histogram, for maps where most bins are empty. A bin
+ * is non-empty if its content or its error is not zero. Under- and overflow bins are not listed,
+ * as the RT loops skip them.
+ *
+ * The list is built by one scan of the histogram and can be kept up to date by filling through
+ * fill()/fillXY() or by calling update() with the filled bin. Bins which become empty again stay
+ * listed, which does not change any result. The calc* functions of RootTools accept the list and
+ * visit only its bins.
+ */
+class SparseBins
+{
+public:
+    explicit SparseBins(const TH1* h);
+
+    void build(const TH1* h);
+    void update(Int_t bin);
+
+    inline Int_t fill(TH1* h, Double_t x, Double_t w = 1.0)
+    {
+        Int_t bin = h->Fill(x, w);
+        update(bin);
+        return bin;
+    }
+
+    inline Int_t fillXY(TH2* h, Double_t x, Double_t y, Double_t w = 1.0)
+    {
+        Int_t bin = h->Fill(x, y, w);
+        update(bin);
+        return bin;
+    }
+
+    inline size_t size() const { return bins.size(); }
+    inline const std::vector<Int_t>& getBins() const { return bins; }
+    inline Int_t getNcells() const { return (nx + 2) * (ny + 2); }
+
+    // calls fn(x, y) for each listed bin
+    template <class F> void forEach(F fn) const
+    {
+        for (Int_t bin : bins)
+            fn(bin % (nx + 2), bin / (nx + 2));
+    }
+
+protected:
+    Int_t nx;
+    Int_t ny;
+    std::vector<Int_t> bins; // global bin numbers
+    std::vector<bool> mask;  // listed bins
+};
+
+}; // namespace RT
+
+#endif /* SPARSEBINS_H */
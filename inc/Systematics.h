@@ -0,0 +1,73 @@
+#ifndef SYSTEMATICS_H
+#define SYSTEMATICS_H
+
+#include "RootTools.h"
+
+#include <TString.h>
+
+#include <vector>
+
+class TH1;
+
+namespace RT
+{
+
+/**
+ * Table of asymmetric systematic uncertainties of many bins from many sources, stored as
+ * structure of arrays: for every source one contiguous array of high and one of low errors over
+ * all bins.
+ *
+ * Sources are uncorrelated and added in quadrature, unless they share a correlation group: the
+ * errors of sources in one group are summed linearly first and the group enters the quadrature
+ * sum as one source. For the total over bins each source is taken as fully correlated between
+ * the bins.
+ *
+ * A table created for a histogram has one bin per cell (GetNcells(), with underflow and
+ * overflow), in the TH1 order.
+ */
+class SystematicsTable
+{
+public:
+    SystematicsTable(size_t bins);
+    SystematicsTable(const TH1* h);
+
+    size_t addSource(const TString& name, Int_t group = -1);
+
+    inline void setError(size_t source, size_t bin, Double_t high, Double_t low)
+    {
+        high_errs[source * bins + bin] = high;
+        low_errs[source * bins + bin] = low;
+    }
+    void setErrors(size_t source, const ErrorsPair* errors);
+    void setErrors(size_t source, const Double_t* high, const Double_t* low);
+
+    inline Double_t* getHigh(size_t source) { return &high_errs[source * bins]; }
+    inline Double_t* getLow(size_t source) { return &low_errs[source * bins]; }
+
+    void combine(Double_t* high, Double_t* low) const;
+    void total(Double_t& high, Double_t& low) const;
+
+    void apply(TH1* h, Bool_t add_to_stat = kTRUE) const;
+
+    inline size_t getBins() const { return bins; }
+    inline size_t getSources() const { return names.size(); }
+    inline const TString& getName(size_t source) const { return names[source]; }
+    inline Int_t getGroup(size_t source) const { return groups[source]; }
+
+private:
+    void combineArrays(const Double_t* high, const Double_t* low, size_t n, Double_t* out_high,
+                       Double_t* out_low) const;
+
+protected:
+    size_t bins;
+
+    std::vector<TString> names;
+    std::vector<Int_t> groups;
+
+    std::vector<Double_t> high_errs;
+    std::vector<Double_t> low_errs;
+};
+
+}; // namespace RT
+
+#endif /* SYSTEMATICS_H */
@@ -0,0 +1,81 @@
+#ifndef THUMBNAIL_H
+#define THUMBNAIL_H
+
+#include "RootTools.h"
+
+#include <algorithm>
+#include <vector>
+
+class TASImage;
+
+namespace RT
+{
+
+/**
+ * Lightweight renderer of histogram thumbnails which does not use TCanvas or TPad. TH1 are drawn
+ * as a line (or markers with option "P"), TH2 as a colour map. The output is an ARGB32 buffer of
+ * width x height pixels (the TASImage layout), row 0 is the top of the image. Axes are drawn as a
+ * frame only, without labels.
+ *
+ * The palette is resolved when the renderer is created or its palette is changed, render() only
+ * reads the histogram and can be called from many threads at once, as long as no new colours are
+ * created meanwhile.
+ */
+class Thumbnail
+{
+public:
+    Thumbnail(UInt_t width, UInt_t height);
+    Thumbnail(UInt_t width, UInt_t height, const Hist::PadFormat& format);
+
+    void setPalette(Int_t palette_id);
+    void setBackground(Int_t color);
+
+    auto render(const TH1* h, const char* opts = "", UChar_t logbits = 0) const
+        -> std::vector<UInt_t>;
+
+    TASImage* toImage(const std::vector<UInt_t>& pixels) const;
+    Bool_t writeImage(const TH1* h, const TString& filename, const char* opts = "",
+                      UChar_t logbits = 0) const;
+
+    inline UInt_t getWidth() const { return width; }
+    inline UInt_t getHeight() const { return height; }
+
+    static UInt_t colorToARGB(Int_t color);
+
+private:
+    void loadStylePalette();
+    void renderTH1(std::vector<UInt_t>& pixels, const TH1* h, const char* opts,
+                   UChar_t logbits) const;
+    void renderTH2(std::vector<UInt_t>& pixels, const TH1* h, UChar_t logbits) const;
+    void drawFrame(std::vector<UInt_t>& pixels) const;
+
+    inline void fillRect(std::vector<UInt_t>& pixels, Int_t x1, Int_t y1, Int_t x2, Int_t y2,
+                         UInt_t argb) const
+    {
+        if (x1 > x2) std::swap(x1, x2);
+        if (y1 > y2) std::swap(y1, y2);
+        if (x1 < 0) x1 = 0;
+        if (y1 < 0) y1 = 0;
+        if (x2 >= (Int_t)width) x2 = width - 1;
+        if (y2 >= (Int_t)height) y2 = height - 1;
+
+        for (Int_t y = y1; y <= y2; ++y)
+            for (Int_t x = x1; x <= x2; ++x)
+                pixels[y * width + x] = argb;
+    }
+
+protected:
+    UInt_t width;
+    UInt_t height;
+    Hist::PadFormat pad_format;
+
+    // frame in pixels, inclusive
+    Int_t fx1, fy1, fx2, fy2;
+
+    UInt_t background;
+    std::vector<UInt_t> palette;
+};
+
+}; // namespace RT
+
+#endif /* THUMBNAIL_H */
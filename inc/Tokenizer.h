@@ -0,0 +1,155 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <string>
+
+namespace RT
+{
+
+enum EmptyFieldPolicy
+{
+    EF_KEEP,          // every field, also empty ones: "a,,b," -> "a", "", "b", ""
+    EF_SKIP,          // no empty fields: "a,,b," -> "a", "b"
+    EF_DROP_TRAILING, // like std::getline, only the field after a final delimiter is dropped
+};
+
+/**
+ * Lazy tokenizer, splits a string at any of the delimiter characters and yields the fields as
+ * pointer and length into the original string, no memory is allocated. The string and the
+ * delimiters must outlive the tokenizer and the yielded fields.
+ *
+ *   for (const RT::Tokenizer::Field& field : RT::Tokenizer(line, ",;", RT::EF_SKIP)) ...
+ */
+class Tokenizer
+{
+public:
+    struct Field
+    {
+        const char* data;
+        size_t size;
+
+        inline bool empty() const { return size == 0; }
+        inline std::string str() const { return std::string(data, size); }
+    };
+
+    class iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Field value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Field* pointer;
+        typedef const Field& reference;
+
+        iterator() : tok(nullptr), pos(0), done(true), field{nullptr, 0} {}
+        iterator(const Tokenizer* tok) : tok(tok), pos(0), done(false), field{nullptr, 0}
+        {
+            if (tok->policy == EF_DROP_TRAILING and tok->length == 0)
+                done = true;
+            else
+                advance();
+        }
+
+        inline reference operator*() const { return field; }
+        inline pointer operator->() const { return &field; }
+
+        inline iterator& operator++()
+        {
+            advance();
+            return *this;
+        }
+        inline iterator operator++(int)
+        {
+            iterator it = *this;
+            advance();
+            return it;
+        }
+
+        inline bool operator==(const iterator& other) const
+        {
+            return done == other.done and (done or pos == other.pos);
+        }
+        inline bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        void advance()
+        {
+            while (true)
+            {
+                if (pos > tok->length)
+                {
+                    done = true;
+                    return;
+                }
+
+                size_t end = tok->find(pos);
+                field.data = tok->str + pos;
+                field.size = end - pos;
+                bool last = end == tok->length;
+                pos = end + 1;
+
+                if (!field.empty()) return;
+                if (tok->policy == EF_KEEP) return;
+                if (tok->policy == EF_DROP_TRAILING)
+                {
+                    if (last) done = true;
+                    return;
+                }
+            }
+        }
+
+        const Tokenizer* tok;
+        size_t pos;
+        bool done;
+        Field field;
+    };
+
+    Tokenizer(const char* str, size_t length, const char* delims, size_t ndelims,
+              EmptyFieldPolicy policy = EF_KEEP)
+        : str(str), length(length), delims(delims), ndelims(ndelims), policy(policy)
+    {
+    }
+    Tokenizer(const char* str, const char* delims, EmptyFieldPolicy policy = EF_KEEP)
+        : Tokenizer(str, strlen(str), delims, strlen(delims), policy)
+    {
+    }
+    Tokenizer(const std::string& str, const char* delims, EmptyFieldPolicy policy = EF_KEEP)
+        : Tokenizer(str.data(), str.size(), delims, strlen(delims), policy)
+    {
+    }
+
+    inline iterator begin() const { return iterator(this); }
+    inline iterator end() const { return iterator(); }
+
+private:
+    // position of the next delimiter from pos on, length if there is none
+    size_t find(size_t pos) const
+    {
+        const char* p = str + pos;
+        const char* e = str + length;
+        if (ndelims == 1)
+        {
+            const char* d = (const char*)memchr(p, delims[0], e - p);
+            return d ? d - str : length;
+        }
+
+        for (; p != e; ++p)
+            if (memchr(delims, *p, ndelims)) break;
+
+        return p - str;
+    }
+
+protected:
+    const char* str;
+    size_t length;
+    const char* delims;
+    size_t ndelims;
+    EmptyFieldPolicy policy;
+};
+
+}; // namespace RT
+
+#endif /* TOKENIZER_H */
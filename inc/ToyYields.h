@@ -0,0 +1,85 @@
+#ifndef TOYYIELDS_H
+#define TOYYIELDS_H
+
+#include <TString.h>
+
+#include <vector>
+
+class TF1;
+class TH1;
+
+namespace RT
+{
+
+enum ToyMode
+{
+    TM_POISSON,   // each bin fluctuated with a Poisson distribution around its content
+    TM_BOOTSTRAP, // the total number of entries resampled from the bin distribution
+};
+
+struct ToyResult
+{
+    std::vector<double> yields; // yield of each toy, NaN if its fit failed
+    size_t failed;              // number of failed fits
+
+    double mean() const;
+    double rms() const;
+    double quantile(double q) const;
+    TH1* makeHistogram(const char* name, Int_t nbins = 100) const;
+};
+
+/**
+ * Toy Monte Carlo of the signal yield of a signal plus background fit, as calculated by
+ * calcSubstractionError(): the integral of the total function minus the integral of the
+ * background function over the yield range.
+ *
+ * Each toy is a pseudo-dataset generated from the data histogram, fitted with a copy of the total
+ * function which starts from the model parameters. The background function takes its parameters
+ * from the fitted total function, by default from its last parameters.
+ *
+ * The toys are shared by a pool of threads, each with its own copies of the histogram and of the
+ * functions. Toy i uses a random generator seeded from the seed and i, so the results do not
+ * depend on the number of threads. The toys are fitted with Minuit2, which can fit in parallel,
+ * set per fit with FitWithMinimizer(); the process-wide default minimizer is not changed. The
+ * constructor enables ROOT thread safety for the whole process, see EnableThreadSafety().
+ */
+class ToyYields
+{
+public:
+    ToyYields(const TH1* data, const TF1* total, const TF1* bkg, UInt_t workers = 0);
+
+    inline void setMode(ToyMode m) { mode = m; }
+    inline void setSeed(ULong64_t s) { seed = s; }
+    inline void setFitOptions(const TString& opts) { fit_options = opts; }
+    inline void setRange(double l, double u)
+    {
+        range_l = l;
+        range_u = u;
+    }
+    // first parameter of the total function used for the background function
+    inline void setBackgroundOffset(Int_t offset) { bkg_offset = offset; }
+
+    ToyResult run(size_t ntoys) const;
+
+    inline UInt_t getWorkers() const { return workers; }
+
+private:
+    void generate(TH1* toy, size_t i) const;
+
+protected:
+    const TH1* data;
+    const TF1* total;
+    const TF1* bkg;
+    UInt_t workers;
+
+    ToyMode mode;
+    ULong64_t seed;
+    TString fit_options;
+    double range_l;
+    double range_u;
+    Int_t bkg_offset;
+};
+
+}; // namespace RT
+
+#endif /* TOYYIELDS_H */
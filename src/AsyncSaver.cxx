@@ -0,0 +1,116 @@
+#include "AsyncSaver.h"
+
+#include "RootTools.h"
+
+#include <TCanvas.h>
+#include <TDirectory.h>
+#include <TError.h>
+#include <TFile.h>
+#include <TROOT.h>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace RT::Exports;
+
+AsyncSaver::AsyncSaver(size_t capacity) : capacity(capacity ? capacity : 1), failed(0) {}
+
+AsyncSaver::~AsyncSaver() { drain(); }
+
+void AsyncSaver::saveAndClose(TCanvas* can, TFile* f, Bool_t export_images, const TString& path)
+{
+    can->Update();
+
+    if (f)
+    {
+        TDirectory::TContext ctx(f);
+        can->Write();
+    }
+
+    if (export_images and gHasImgExportEnabled) render(can, path);
+
+    can->Close();
+}
+
+/**
+ * @brief Blocks until all canvases are exported.
+ */
+void AsyncSaver::drain()
+{
+    while (!renders.empty())
+        reap(kTRUE);
+}
+
+/**
+ * @brief Number of canvases still being exported.
+ */
+size_t AsyncSaver::pending()
+{
+    reap(kFALSE);
+    return renders.size();
+}
+
+void AsyncSaver::render(TCanvas* can, const TString& path)
+{
+    reap(kFALSE);
+    while (renders.size() >= capacity)
+        reap(kTRUE);
+
+    std::vector<char> blob = SerializeCanvas(can);
+
+    // buffered output would be flushed again by the child
+    fflush(stdout);
+    fflush(stderr);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        ExportImages(can, path);
+        return;
+    }
+
+    if (pid == 0)
+    {
+        gROOT->SetBatch(kTRUE);
+        TCanvas* copy = DeserializeCanvas(blob.data(), blob.size());
+        if (!copy) _exit(EXIT_FAILURE);
+
+        ExportImages(copy, path);
+        _exit(EXIT_SUCCESS);
+    }
+
+    Render r;
+    r.pid = pid;
+    r.name = can->GetName();
+    renders.push_back(r);
+}
+
+/**
+ * @brief Collects finished workers; with wait the oldest one is waited for.
+ */
+void AsyncSaver::reap(Bool_t wait)
+{
+    for (size_t i = 0; i < renders.size();)
+    {
+        int status = 0;
+        pid_t pid = waitpid(renders[i].pid, &status, wait ? 0 : WNOHANG);
+        if (pid == 0)
+        {
+            ++i;
+            continue;
+        }
+
+        if (pid < 0 or !WIFEXITED(status) or WEXITSTATUS(status) != EXIT_SUCCESS)
+        {
+            Error("AsyncSaver", "Export of canvas %s failed", renders[i].name.Data());
+            ++failed;
+        }
+
+        renders.erase(renders.begin() + i);
+        wait = kFALSE;
+    }
+}
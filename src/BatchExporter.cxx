@@ -0,0 +1,169 @@
+#include "BatchExporter.h"
+
+#include "Parallel.h"
+#include "RootTools.h"
+
+#include <TCanvas.h>
+#include <TError.h>
+#include <TROOT.h>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace RT::Exports;
+
+static TString last_error;
+
+static void CaptureErrorHandler(int level, Bool_t abort, const char* location, const char* msg)
+{
+    if (level >= kError) last_error = TString::Format("%s: %s", location, msg);
+    DefaultErrorHandler(level, abort, location, msg);
+}
+
+BatchExporter::BatchExporter(unsigned int workers) : workers(GetWorkers(workers)) {}
+
+void BatchExporter::add(TCanvas* can, const TString& path)
+{
+    can->Update();
+
+    Job job;
+    job.name = can->GetName();
+    job.path = path;
+    job.blob = SerializeCanvas(can);
+    jobs.push_back(job);
+}
+
+/**
+ * @brief Renders all added canvases and waits for the workers. Each canvas gets its result, also
+ * when the worker rendering it crashed. The list of canvases is cleared afterwards.
+ *
+ * @return results in the order the canvases were added
+ */
+auto BatchExporter::run() -> std::vector<ExportResult>
+{
+    std::vector<ExportResult> results(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        results[i].name = jobs[i].name;
+        results[i].ok = kFALSE;
+        results[i].message = "not rendered";
+    }
+
+    unsigned int stride = workers < jobs.size() ? workers : jobs.size();
+
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+
+    // buffered output would be flushed again by each child
+    fflush(stdout);
+    fflush(stderr);
+
+    for (unsigned int w = 0; w < stride; ++w)
+    {
+        int pipefd[2];
+        if (pipe(pipefd))
+        {
+            perror("pipe");
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            perror("fork");
+            close(pipefd[0]);
+            close(pipefd[1]);
+            break;
+        }
+
+        if (pid == 0)
+        {
+            close(pipefd[0]);
+            work(w, stride, pipefd[1]);
+            close(pipefd[1]);
+            _exit(EXIT_SUCCESS);
+        }
+
+        close(pipefd[1]);
+        pids.push_back(pid);
+        fds.push_back(pipefd[0]);
+    }
+
+    for (size_t w = 0; w < pids.size(); ++w)
+    {
+        std::string report;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(fds[w], buf, sizeof(buf))) > 0)
+            report.append(buf, n);
+        close(fds[w]);
+
+        std::istringstream ss(report);
+        std::string line;
+        while (std::getline(ss, line))
+        {
+            size_t idx = 0;
+            int ok = 0;
+            int pos = 0;
+            if (sscanf(line.c_str(), "%zu %d %n", &idx, &ok, &pos) < 2 or idx >= results.size())
+                continue;
+
+            results[idx].ok = ok;
+            results[idx].message = line.c_str() + pos;
+        }
+
+        int status = 0;
+        waitpid(pids[w], &status, 0);
+        if (WIFSIGNALED(status))
+        {
+            for (size_t i = w; i < results.size(); i += stride)
+            {
+                if (results[i].ok) continue;
+                results[i].message =
+                    TString::Format("worker terminated by signal %d", WTERMSIG(status));
+            }
+        }
+    }
+
+    jobs.clear();
+    return results;
+}
+
+void BatchExporter::work(unsigned int worker, unsigned int stride, int fd) const
+{
+    gROOT->SetBatch(kTRUE);
+    SetErrorHandler(CaptureErrorHandler);
+
+    for (size_t i = worker; i < jobs.size(); i += stride)
+    {
+        last_error = "";
+
+        const Job& job = jobs[i];
+        TCanvas* can = DeserializeCanvas(job.blob.data(), job.blob.size());
+        if (can)
+        {
+            ExportImages(can, job.path);
+            delete can;
+        }
+        else
+            last_error = "canvas could not be deserialized";
+
+        TString msg = last_error;
+        msg.ReplaceAll("\n", " ");
+        TString line = TString::Format("%zu %d %s\n", i, msg.IsNull() ? 1 : 0, msg.Data());
+
+        const char* data = line.Data();
+        ssize_t left = line.Length();
+        while (left > 0)
+        {
+            ssize_t n = write(fd, data, left);
+            if (n < 0) break;
+            data += n;
+            left -= n;
+        }
+    }
+}
@@ -0,0 +1,405 @@
+#include "Columnar.h"
+
+#include <TDirectory.h>
+#include <TError.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TList.h>
+
+#include <cstring>
+#include <fstream>
+#include <set>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace RT;
+
+static const char columnar_magic[8] = {'R', 'T', 'C', 'O', 'L', 'U', 'M', '1'};
+
+struct ColumnarHeader
+{
+    char magic[8];
+    ULong64_t nhists;
+    ULong64_t index_off;
+    ULong64_t names_off;
+    ULong64_t edges_off;
+    ULong64_t contents_off;
+    ULong64_t sumw2_off;
+    ULong64_t nedges;
+    ULong64_t ncells;
+    ULong64_t total_size;
+};
+
+struct ColumnarRecord
+{
+    Int_t dim;
+    Int_t nbins[3];
+    Int_t variable[3];
+    Int_t has_sumw2;
+    Double_t entries;
+    ULong64_t name;  // offset in names
+    ULong64_t title; // offset in names
+    ULong64_t edges[3];
+    ULong64_t cells;
+};
+
+static inline ULong64_t Align8(ULong64_t off) { return (off + 7) & ~7ULL; }
+
+// an array of n elements of the given size at off lies within a mapping of size bytes
+static inline bool InMapping(ULong64_t off, ULong64_t n, ULong64_t elem, ULong64_t size)
+{
+    return off <= size and n <= (size - off) / elem;
+}
+
+/**
+ * @brief Checks that the index, the arrays and all per-histogram offsets lie within the mapped
+ * file, so a corrupt or truncated file can not give reads out of it.
+ */
+static bool IsValidColumnar(const char* base, ULong64_t size)
+{
+    const ColumnarHeader* hdr = (const ColumnarHeader*)base;
+    if (memcmp(hdr->magic, columnar_magic, sizeof(columnar_magic)) or hdr->total_size != size)
+        return false;
+
+    if (hdr->index_off % 8 or hdr->edges_off % 8 or hdr->contents_off % 8 or hdr->sumw2_off % 8)
+        return false;
+    if (!InMapping(hdr->index_off, hdr->nhists, sizeof(ColumnarRecord), size) or
+        !InMapping(hdr->edges_off, hdr->nedges, sizeof(Double_t), size) or
+        !InMapping(hdr->contents_off, hdr->ncells, sizeof(Double_t), size) or
+        !InMapping(hdr->sumw2_off, hdr->ncells, sizeof(Double_t), size))
+        return false;
+    if (hdr->names_off > hdr->edges_off) return false;
+
+    const ColumnarRecord* records = (const ColumnarRecord*)(base + hdr->index_off);
+    const char* names = base + hdr->names_off;
+    const ULong64_t names_size = hdr->edges_off - hdr->names_off;
+
+    for (ULong64_t i = 0; i < hdr->nhists; ++i)
+    {
+        const ColumnarRecord& rec = records[i];
+        if (rec.dim < 1 or rec.dim > 3 or (rec.has_sumw2 != 0 and rec.has_sumw2 != 1))
+            return false;
+
+        ULong64_t ncells = 1;
+        for (int a = 0; a < 3; ++a)
+        {
+            if (rec.nbins[a] < 1 or (ULong64_t)rec.nbins[a] >= hdr->nedges) return false;
+            if (rec.edges[a] > hdr->nedges - (rec.nbins[a] + 1)) return false;
+
+            // axes above the dimension have no under- and overflow
+            ULong64_t cells = a < rec.dim ? rec.nbins[a] + 2 : 1;
+            if (ncells > hdr->ncells / cells) return false;
+            ncells *= cells;
+        }
+        if (ncells > (ULong64_t)kMaxInt or rec.cells > hdr->ncells - ncells) return false;
+
+        if (rec.name >= names_size or !memchr(names + rec.name, 0, names_size - rec.name))
+            return false;
+        if (rec.title >= names_size or !memchr(names + rec.title, 0, names_size - rec.title))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Collects the columns of many histograms before they are written at once.
+ */
+class ColumnarBuilder
+{
+public:
+    void add(const TH1* h, const TString& name)
+    {
+        ColumnarRecord rec;
+        memset(&rec, 0, sizeof(rec));
+
+        rec.dim = h->GetDimension();
+        rec.entries = h->GetEntries();
+        rec.has_sumw2 = h->GetSumw2N() > 0;
+
+        rec.name = names.size();
+        names.insert(names.end(), name.Data(), name.Data() + name.Length() + 1);
+        rec.title = names.size();
+        names.insert(names.end(), h->GetTitle(), h->GetTitle() + strlen(h->GetTitle()) + 1);
+
+        const TAxis* axes[3] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+        for (int a = 0; a < 3; ++a)
+        {
+            Int_t n = axes[a]->GetNbins();
+            rec.nbins[a] = n;
+            rec.variable[a] = axes[a]->IsVariableBinSize();
+            rec.edges[a] = edges.size();
+
+            const TArrayD* xbins = axes[a]->GetXbins();
+            if (xbins->GetSize() == n + 1)
+                edges.insert(edges.end(), xbins->GetArray(), xbins->GetArray() + n + 1);
+            else
+            {
+                for (Int_t i = 1; i <= n; ++i)
+                    edges.push_back(axes[a]->GetBinLowEdge(i));
+                edges.push_back(axes[a]->GetBinUpEdge(n));
+            }
+        }
+
+        Int_t ncells = h->GetNcells();
+        rec.cells = contents.size();
+
+        // TH1D, TH2D, TH3D keep their bins in a TArrayD which is copied as a whole
+        const TArrayD* arr = dynamic_cast<const TArrayD*>(h);
+        if (arr and arr->GetSize() == ncells)
+            contents.insert(contents.end(), arr->GetArray(), arr->GetArray() + ncells);
+        else
+            for (Int_t bin = 0; bin < ncells; ++bin)
+                contents.push_back(h->GetBinContent(bin));
+
+        if (rec.has_sumw2)
+        {
+            const Double_t* sw2 = h->GetSumw2()->GetArray();
+            sumw2.insert(sumw2.end(), sw2, sw2 + ncells);
+        }
+        else
+            for (size_t i = rec.cells; i < contents.size(); ++i)
+                sumw2.push_back(fabs(contents[i]));
+
+        records.push_back(rec);
+    }
+
+    Bool_t write(const TString& filename) const
+    {
+        ColumnarHeader hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        memcpy(hdr.magic, columnar_magic, sizeof(columnar_magic));
+
+        hdr.nhists = records.size();
+        hdr.nedges = edges.size();
+        hdr.ncells = contents.size();
+
+        hdr.index_off = Align8(sizeof(hdr));
+        hdr.names_off = hdr.index_off + records.size() * sizeof(ColumnarRecord);
+        hdr.edges_off = Align8(hdr.names_off + names.size());
+        hdr.contents_off = hdr.edges_off + edges.size() * sizeof(Double_t);
+        hdr.sumw2_off = hdr.contents_off + contents.size() * sizeof(Double_t);
+        hdr.total_size = hdr.sumw2_off + sumw2.size() * sizeof(Double_t);
+
+        std::ofstream ofs(filename.Data(), std::ios::binary | std::ios::trunc);
+        if (!ofs)
+        {
+            Error("WriteColumnar", "Can't write file %s", filename.Data());
+            return kFALSE;
+        }
+
+        const char zeros[8] = {0};
+        auto pad_to = [&](ULong64_t pos) { ofs.write(zeros, pos - (ULong64_t)ofs.tellp()); };
+
+        ofs.write((const char*)&hdr, sizeof(hdr));
+        pad_to(hdr.index_off);
+        ofs.write((const char*)records.data(), records.size() * sizeof(ColumnarRecord));
+        ofs.write(names.data(), names.size());
+        pad_to(hdr.edges_off);
+        ofs.write((const char*)edges.data(), edges.size() * sizeof(Double_t));
+        ofs.write((const char*)contents.data(), contents.size() * sizeof(Double_t));
+        ofs.write((const char*)sumw2.data(), sumw2.size() * sizeof(Double_t));
+
+        ofs.close();
+        if (!ofs)
+        {
+            Error("WriteColumnar", "Can't write file %s", filename.Data());
+            return kFALSE;
+        }
+
+        return kTRUE;
+    }
+
+    inline size_t size() const { return records.size(); }
+
+private:
+    std::vector<ColumnarRecord> records;
+    std::vector<char> names;
+    std::vector<Double_t> edges;
+    std::vector<Double_t> contents;
+    std::vector<Double_t> sumw2;
+};
+
+/**
+ * @brief Writes the histograms, they are stored under their names.
+ *
+ * @param hists histograms
+ * @param filename output file name
+ * @return true on success
+ */
+Bool_t RT::WriteColumnar(const std::vector<TH1*>& hists, const TString& filename)
+{
+    ColumnarBuilder builder;
+    for (const TH1* h : hists)
+        builder.add(h, h->GetName());
+
+    return builder.write(filename);
+}
+
+static void CollectDirectory(TDirectory* dir, const TString& prefix, ColumnarBuilder& builder)
+{
+    TList* keys = dir->GetListOfKeys();
+    if (!keys)
+    {
+        // in-memory directory
+        TIter next(dir->GetList());
+        TObject* obj = nullptr;
+        while ((obj = next()))
+        {
+            TH1* h = dynamic_cast<TH1*>(obj);
+            if (h) builder.add(h, prefix + h->GetName());
+        }
+        return;
+    }
+
+    std::set<TString> seen;
+
+    TIter next(keys);
+    TKey* key = nullptr;
+    while ((key = (TKey*)next()))
+    {
+        // keys are ordered by decreasing cycle, only the newest one is used
+        if (!seen.insert(key->GetName()).second) continue;
+
+        TString name = prefix + key->GetName();
+
+        if (TString(key->GetClassName()).BeginsWith("TDirectory"))
+        {
+            TDirectory* sub = dir->GetDirectory(key->GetName());
+            if (sub) CollectDirectory(sub, name + "/", builder);
+            continue;
+        }
+
+        TObject* obj = key->ReadObj();
+        TH1* h = dynamic_cast<TH1*>(obj);
+        if (h)
+        {
+            h->SetDirectory(nullptr);
+            builder.add(h, name);
+        }
+        delete obj;
+    }
+}
+
+/**
+ * @brief Writes all histograms of the directory and its subdirectories, histograms in
+ * subdirectories are stored as "dir/name".
+ *
+ * @param dir source directory
+ * @param filename output file name
+ * @return number of written histograms, -1 on failure
+ */
+Int_t RT::WriteColumnar(TDirectory* dir, const TString& filename)
+{
+    ColumnarBuilder builder;
+    CollectDirectory(dir, "", builder);
+
+    return builder.write(filename) ? (Int_t)builder.size() : -1;
+}
+
+ColumnarFile::ColumnarFile(const TString& filename) : data(nullptr), data_size(0)
+{
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(filename);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) or (size_t)st.st_size < sizeof(ColumnarHeader))
+    {
+        Error("ColumnarFile", "File %s is not valid", filename.Data());
+        close(fd);
+        return;
+    }
+
+    void* mem = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+    {
+        perror(filename);
+        return;
+    }
+
+    const char* base = (const char*)mem;
+    const ColumnarHeader* hdr = (const ColumnarHeader*)base;
+    if (!IsValidColumnar(base, st.st_size))
+    {
+        Error("ColumnarFile", "File %s is not valid", filename.Data());
+        munmap(mem, st.st_size);
+        return;
+    }
+
+    data = mem;
+    data_size = st.st_size;
+
+    const ColumnarRecord* records = (const ColumnarRecord*)(base + hdr->index_off);
+    const char* names = base + hdr->names_off;
+    const Double_t* edges = (const Double_t*)(base + hdr->edges_off);
+    const Double_t* contents = (const Double_t*)(base + hdr->contents_off);
+    const Double_t* sumw2 = (const Double_t*)(base + hdr->sumw2_off);
+
+    views.resize(hdr->nhists);
+    for (size_t i = 0; i < hdr->nhists; ++i)
+    {
+        const ColumnarRecord& rec = records[i];
+        HistView& v = views[i];
+
+        v.dim = rec.dim;
+        for (int a = 0; a < 3; ++a)
+        {
+            v.nbins[a] = rec.nbins[a];
+            v.variable[a] = rec.variable[a];
+            v.edges[a] = edges + rec.edges[a];
+        }
+        v.contents = contents + rec.cells;
+        v.sumw2 = rec.has_sumw2 ? sumw2 + rec.cells : nullptr;
+        v.entries = rec.entries;
+        v.name = names + rec.name;
+        v.title = names + rec.title;
+
+        index[v.name] = i;
+    }
+}
+
+ColumnarFile::~ColumnarFile()
+{
+    if (data) munmap(data, data_size);
+}
+
+const HistView* ColumnarFile::find(const TString& name) const
+{
+    auto it = index.find(name.Data());
+    if (it == index.end()) return nullptr;
+
+    return &views[it->second];
+}
+
+/**
+ * @brief Creates the histogram, owned by the caller.
+ *
+ * @return new histogram, nullptr if not found
+ */
+TH1* ColumnarFile::makeHistogram(const TString& name) const
+{
+    const HistView* v = find(name);
+    if (!v) return nullptr;
+
+    return MakeHistogram(*v);
+}
+
+/**
+ * @brief Creates all histograms in the order of the file, owned by the caller.
+ */
+auto ColumnarFile::makeHistograms() const -> std::vector<TH1*>
+{
+    std::vector<TH1*> hists;
+    for (const auto& v : views)
+        hists.push_back(MakeHistogram(v));
+
+    return hists;
+}
@@ -0,0 +1,363 @@
+#include "CompactHist.h"
+
+#include "HistCache.h"
+
+#include <TH1.h>
+
+#include <cmath>
+#include <cstdio>
+
+using namespace RT;
+
+/**
+ * @brief Scales the values to 16-bit integers, scale is the value of one unit.
+ */
+static void Quantize(const Double_t* v, Int_t n, Short_t* q, Double_t& scale)
+{
+    Double_t max = 0.0;
+    for (Int_t i = 0; i < n; ++i)
+        max = std::max(max, fabs(v[i]));
+
+    scale = max / 32767.0;
+    Double_t inv = scale > 0.0 ? 1.0 / scale : 0.0;
+    for (Int_t i = 0; i < n; ++i)
+        q[i] = (Short_t)lround(v[i] * inv);
+}
+
+/**
+ * @param h source histogram, it can be deleted afterwards
+ * @param precision storage precision
+ */
+CompactHist::CompactHist(const TH1* h, CompactPrecision precision)
+    : name(h->GetName()), title(h->GetTitle()), dim(h->GetDimension()), entries(h->GetEntries()),
+      has_sumw2(h->GetSumw2N() > 0), precision(precision), ncells(h->GetNcells())
+{
+    const TAxis* axes[3] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+    for (int a = 0; a < 3; ++a)
+    {
+        Int_t n = axes[a]->GetNbins();
+        nbins[a] = n;
+        variable[a] = axes[a]->IsVariableBinSize();
+
+        for (Int_t i = 1; i <= n; ++i)
+            edges[a].push_back(axes[a]->GetBinLowEdge(i));
+        edges[a].push_back(axes[a]->GetBinUpEdge(n));
+    }
+
+    const TArrayD* arr = dynamic_cast<const TArrayD*>(h);
+    const Double_t* contents = (arr and arr->GetSize() == ncells) ? arr->GetArray() : nullptr;
+    const Double_t* sumw2 = has_sumw2 ? h->GetSumw2()->GetArray() : nullptr;
+
+    size_t nblocks = (ncells + block_size - 1) / block_size;
+    offsets.assign(nblocks, -1);
+    if (precision == CP_BLOCK16) scales.assign(2 * nblocks, 0.0);
+
+    std::vector<Double_t> cont(block_size), err(block_size);
+    std::vector<Short_t> q(block_size);
+    for (size_t b = 0; b < nblocks; ++b)
+    {
+        Int_t first = b * block_size;
+        Int_t n = blockLength(b);
+
+        bool empty = true;
+        for (Int_t i = 0; i < n; ++i)
+        {
+            Int_t bin = first + i;
+            cont[i] = contents ? contents[bin] : h->GetBinContent(bin);
+            err[i] = sumw2 ? sqrt(sumw2[bin]) : sqrt(fabs(cont[i]));
+            if (cont[i] != 0.0 or err[i] != 0.0) empty = false;
+        }
+        if (empty) continue;
+
+        if (precision == CP_FLOAT)
+        {
+            offsets[b] = fdata.size();
+            fdata.insert(fdata.end(), cont.begin(), cont.begin() + n);
+            fdata.insert(fdata.end(), err.begin(), err.begin() + n);
+        }
+        else
+        {
+            offsets[b] = qdata.size();
+            Quantize(cont.data(), n, q.data(), scales[2 * b]);
+            qdata.insert(qdata.end(), q.begin(), q.begin() + n);
+            Quantize(err.data(), n, q.data(), scales[2 * b + 1]);
+            qdata.insert(qdata.end(), q.begin(), q.begin() + n);
+        }
+    }
+
+    fdata.shrink_to_fit();
+    qdata.shrink_to_fit();
+}
+
+Int_t CompactHist::GetBin(Int_t x, Int_t y, Int_t z) const
+{
+    if (dim < 2) return x;
+    if (dim < 3) return x + (nbins[0] + 2) * y;
+    return x + (nbins[0] + 2) * (y + (nbins[1] + 2) * z);
+}
+
+/**
+ * @brief Content of the cell, 0 for bins outside [0, GetNcells()).
+ */
+Double_t CompactHist::GetBinContent(Int_t bin) const
+{
+    if (bin < 0 or bin >= ncells) return 0.0;
+
+    size_t b = bin / block_size;
+    Long64_t off = offsets[b];
+    if (off < 0) return 0.0;
+
+    Int_t i = bin - b * block_size;
+    if (precision == CP_FLOAT) return fdata[off + i];
+    return qdata[off + i] * scales[2 * b];
+}
+
+/**
+ * @brief Error of the cell, 0 for bins outside [0, GetNcells()).
+ */
+Double_t CompactHist::GetBinError(Int_t bin) const
+{
+    if (bin < 0 or bin >= ncells) return 0.0;
+
+    size_t b = bin / block_size;
+    Long64_t off = offsets[b];
+    if (off < 0) return 0.0;
+
+    Int_t i = bin - b * block_size + blockLength(b);
+    if (precision == CP_FLOAT) return fdata[off + i];
+    return qdata[off + i] * scales[2 * b + 1];
+}
+
+/**
+ * @brief Size of the stored blocks and of the block index in bytes.
+ */
+size_t CompactHist::getMemory() const
+{
+    return offsets.size() * sizeof(Long64_t) + fdata.size() * sizeof(Float_t) +
+           qdata.size() * sizeof(Short_t) + scales.size() * sizeof(Double_t);
+}
+
+void CompactHist::decodeBlock(size_t b, Double_t* contents, Double_t* errors) const
+{
+    Int_t n = blockLength(b);
+    Long64_t off = offsets[b];
+
+    if (precision == CP_FLOAT)
+    {
+        const Float_t* f = fdata.data() + off;
+        for (Int_t i = 0; i < n; ++i)
+            contents[i] = f[i];
+        for (Int_t i = 0; i < n; ++i)
+            errors[i] = f[n + i];
+    }
+    else
+    {
+        const Short_t* q = qdata.data() + off;
+        Double_t sc = scales[2 * b];
+        Double_t se = scales[2 * b + 1];
+        for (Int_t i = 0; i < n; ++i)
+            contents[i] = q[i] * sc;
+        for (Int_t i = 0; i < n; ++i)
+            errors[i] = q[n + i] * se;
+    }
+}
+
+void CompactHist::encodeErrors(size_t b, const Double_t* errors)
+{
+    Int_t n = blockLength(b);
+    Long64_t off = offsets[b];
+
+    if (precision == CP_FLOAT)
+    {
+        Float_t* f = fdata.data() + off + n;
+        for (Int_t i = 0; i < n; ++i)
+            f[i] = errors[i];
+    }
+    else
+        Quantize(errors, n, qdata.data() + off + n, scales[2 * b + 1]);
+}
+
+/**
+ * @brief Calls fn(i, bin) for each cell of block b which is not an under- or overflow bin.
+ */
+template <class F> void CompactHist::forEachInRange(size_t b, F fn) const
+{
+    Int_t first = b * block_size;
+    Int_t n = blockLength(b);
+
+    Int_t sx = nbins[0] + 2;
+    Int_t sy = dim > 1 ? nbins[1] + 2 : 1;
+    Int_t x = first % sx;
+    Int_t y = (first / sx) % sy;
+    Int_t z = first / (sx * sy);
+
+    for (Int_t i = 0; i < n; ++i)
+    {
+        if (x >= 1 and x <= nbins[0] and (dim < 2 or (y >= 1 and y <= nbins[1])) and
+            (dim < 3 or (z >= 1 and z <= nbins[2])))
+            fn(i, first + i);
+
+        if (++x == sx)
+        {
+            x = 0;
+            if (++y == sy)
+            {
+                y = 0;
+                ++z;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sums the contents and the squared errors.
+ *
+ * @param content sum of contents
+ * @param error2 sum of squared errors
+ * @param verbose print every non-empty bin
+ */
+void CompactHist::getTotals(Double_t& content, Double_t& error2, bool verbose) const
+{
+    content = 0.0;
+    error2 = 0.0;
+
+    std::vector<Double_t> cont(block_size), err(block_size);
+    for (size_t b = 0; b < offsets.size(); ++b)
+    {
+        if (offsets[b] < 0) continue;
+
+        decodeBlock(b, cont.data(), err.data());
+        forEachInRange(b, [&](Int_t i, Int_t bin) {
+            content += cont[i];
+            error2 += err[i] * err[i];
+            if (verbose and (cont[i] != 0.0 or err[i] != 0.0))
+                printf("[%d] V: %g -> %g  E: %g -> %g\n", bin, cont[i], content, err[i], error2);
+        });
+    }
+}
+
+/**
+ * @brief Replaces the error of each in-range bin by fn(content, error).
+ */
+template <class F> void CompactHist::transformErrors(F fn)
+{
+    std::vector<Double_t> cont(block_size), err(block_size);
+    for (size_t b = 0; b < offsets.size(); ++b)
+    {
+        // empty bins keep zero errors in both operations
+        if (offsets[b] < 0) continue;
+
+        decodeBlock(b, cont.data(), err.data());
+        forEachInRange(b, [&](Int_t i, Int_t) { err[i] = fn(cont[i], err[i]); });
+        encodeErrors(b, err.data());
+    }
+
+    has_sumw2 = kTRUE;
+}
+
+/**
+ * @brief Same as calcErrorPropagationMult() of TH1 for 1D and 2D histograms. For 3D histograms
+ * all bins which are not under- or overflow are used; the TH1 version walks only the x-y grid.
+ */
+void CompactHist::propagateErrorsMult(double val, double err)
+{
+    transformErrors([=](Double_t c, Double_t e) {
+        double bc = c / val;
+        double be = e / val;
+        return sqrt(val * val * be * be + bc * bc * err * err);
+    });
+}
+
+/**
+ * @brief Same as calcErrorPropagationDiv() of TH1 for 1D and 2D histograms. For 3D histograms
+ * all bins which are not under- or overflow are used; the TH1 version walks only the x-y grid.
+ */
+void CompactHist::propagateErrorsDiv(double val, double err)
+{
+    transformErrors([=](Double_t c, Double_t e) {
+        double bc = c * val;
+        double be = e * val;
+        return sqrt(val * val * be * be + bc * bc * err * err) / (val * val);
+    });
+}
+
+/**
+ * @brief Creates a TH1D, TH2D or TH3D with the decoded bins, owned by the caller and not
+ * attached to a directory.
+ */
+TH1* CompactHist::makeHistogram() const
+{
+    HistView v;
+    v.dim = dim;
+    for (int a = 0; a < 3; ++a)
+    {
+        v.nbins[a] = nbins[a];
+        v.variable[a] = variable[a];
+        v.edges[a] = edges[a].data();
+    }
+    v.contents = nullptr;
+    v.sumw2 = nullptr;
+    v.entries = entries;
+    v.name = name.Data();
+    v.title = title.Data();
+
+    TH1* h = MakeHistogram(v);
+    if (has_sumw2) h->Sumw2();
+
+    Double_t* contents = dynamic_cast<TArrayD*>(h)->GetArray();
+    Double_t* sumw2 = has_sumw2 ? h->GetSumw2()->GetArray() : nullptr;
+
+    std::vector<Double_t> err(block_size);
+    for (size_t b = 0; b < offsets.size(); ++b)
+    {
+        if (offsets[b] < 0) continue;
+
+        Int_t first = b * block_size;
+        decodeBlock(b, contents + first, err.data());
+        if (sumw2)
+            for (Int_t i = 0; i < blockLength(b); ++i)
+                sumw2[first + i] = err[i] * err[i];
+    }
+
+    h->SetEntries(entries);
+
+    return h;
+}
+
+double RT::calcTotalContent(const CompactHist& h, bool verbose)
+{
+    Double_t content, error2;
+    h.getTotals(content, error2, verbose);
+
+    printf("  content = %g\n", content);
+    return content;
+}
+
+double RT::calcTotalError(const CompactHist& h, bool verbose)
+{
+    Double_t content, error2;
+    h.getTotals(content, error2, verbose);
+
+    printf("  sqrt(%g) = %g\n", error2, sqrt(error2));
+    return sqrt(error2);
+}
+
+void RT::calcTotalHistogramValues(const CompactHist& h, double& content, double& error,
+                                  bool verbose)
+{
+    Double_t error2;
+    h.getTotals(content, error2, verbose);
+    error = sqrt(error2);
+
+    printf("  content = %g  sqrt(%g) = %g\n", content, error2, error);
+}
+
+void RT::calcErrorPropagationMult(CompactHist& h, double val, double err)
+{
+    h.propagateErrorsMult(val, err);
+}
+
+void RT::calcErrorPropagationDiv(CompactHist& h, double val, double err)
+{
+    h.propagateErrorsDiv(val, err);
+}
@@ -0,0 +1,236 @@
+#include "DirectoryProcessor.h"
+
+#include "Parallel.h"
+#include "RootTools.h"
+
+#include <TClass.h>
+#include <TDirectory.h>
+#include <TError.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TRegexp.h>
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+
+using namespace RT;
+
+void ProcessSummary::print() const
+{
+    printf("Visited: %zu  matched: %zu  processed: %zu  failed: %zu\n", visited, matched,
+           processed, failed);
+    for (const auto& p : paths)
+        printf("  [ OK ] %s\n", p.Data());
+    for (const auto& p : errors)
+        printf("  [FAIL] %s\n", p.Data());
+}
+
+struct ProcessItem
+{
+    TDirectory* dir; // source directory
+    TKey* key;       // nullptr for objects of in-memory directories
+    TObject* obj;
+    TString path;
+    TH1* h;
+    TH1* result;
+};
+
+static void CollectItems(TDirectory* dir, const TString& prefix, const TRegexp* re, TClass* cl,
+                         std::vector<ProcessItem>& items, ProcessSummary& summary)
+{
+    auto accept = [&](const TString& path, TClass* obj_cl) {
+        ++summary.visited;
+        if (!obj_cl or !obj_cl->InheritsFrom(TH1::Class())) return false;
+        if (cl and !obj_cl->InheritsFrom(cl)) return false;
+        if (re and path.Index(*re) == kNPOS) return false;
+
+        ++summary.matched;
+        return true;
+    };
+
+    TList* keys = dir->GetListOfKeys();
+    if (!keys)
+    {
+        TIter next(dir->GetList());
+        TObject* obj = nullptr;
+        while ((obj = next()))
+        {
+            TString path = prefix + obj->GetName();
+            if (obj->InheritsFrom(TDirectory::Class()))
+                CollectItems((TDirectory*)obj, path + "/", re, cl, items, summary);
+            else if (accept(path, obj->IsA()))
+                items.push_back({dir, nullptr, obj, path, nullptr, nullptr});
+        }
+        return;
+    }
+
+    std::set<TString> seen;
+
+    TIter next(keys);
+    TKey* key = nullptr;
+    while ((key = (TKey*)next()))
+    {
+        // keys are ordered by decreasing cycle, only the newest one is used
+        if (!seen.insert(key->GetName()).second) continue;
+
+        TString path = prefix + key->GetName();
+        if (TString(key->GetClassName()).BeginsWith("TDirectory"))
+        {
+            TDirectory* sub = dir->GetDirectory(key->GetName());
+            if (sub) CollectItems(sub, path + "/", re, cl, items, summary);
+        }
+        else if (accept(path, TClass::GetClass(key->GetClassName())))
+            items.push_back({dir, key, nullptr, path, nullptr, nullptr});
+    }
+}
+
+/**
+ * @param workers number of threads, 0 for one per CPU
+ */
+DirectoryProcessor::DirectoryProcessor(UInt_t workers) : workers(GetWorkers(workers))
+{
+    EnableThreadSafety();
+}
+
+/**
+ * @brief Applies the operation to all matching histograms of source.
+ *
+ * @param source source directory or file, it is not modified
+ * @param target target directory, can be the source; existing objects are replaced
+ * @param op operation
+ * @return summary of the processed objects
+ */
+ProcessSummary DirectoryProcessor::run(TDirectory* source, TDirectory* target,
+                                       const Operation& op) const
+{
+    ProcessSummary summary = {0, 0, 0, 0, {}, {}};
+
+    std::unique_ptr<TRegexp> re;
+    if (!pattern.IsNull()) re.reset(new TRegexp(pattern, kTRUE));
+
+    TClass* cl = nullptr;
+    if (!class_name.IsNull())
+    {
+        cl = TClass::GetClass(class_name);
+        if (!cl)
+        {
+            Error("DirectoryProcessor", "Unknown class %s", class_name.Data());
+            return summary;
+        }
+    }
+
+    std::vector<ProcessItem> items;
+    CollectItems(source, "", re.get(), cl, items, summary);
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+
+    const size_t batch = 16 * workers;
+    for (size_t first = 0; first < items.size(); first += batch)
+    {
+        size_t last = std::min(first + batch, items.size());
+
+        for (size_t i = first; i < last; ++i)
+        {
+            ProcessItem& it = items[i];
+            TObject* obj = it.key ? it.key->ReadObj() : it.obj->Clone();
+            it.h = dynamic_cast<TH1*>(obj);
+            if (it.h)
+                it.h->SetDirectory(nullptr);
+            else
+                delete obj;
+        }
+
+        ParallelFor(last - first, workers, [&](size_t i) {
+            ProcessItem& it = items[first + i];
+            if (it.h) it.result = op(it.h, it.path);
+        });
+
+        for (size_t i = first; i < last; ++i)
+        {
+            ProcessItem& it = items[i];
+            if (it.result != it.h) delete it.h;
+
+            if (!it.result)
+            {
+                ++summary.failed;
+                summary.errors.push_back(it.path);
+                continue;
+            }
+
+            TDirectory* dir = target;
+            TString name = it.path;
+            Ssiz_t slash = name.Last('/');
+            if (slash != kNPOS)
+            {
+                TString path = name(0, slash);
+                dir = target->mkdir(path, "", kTRUE);
+                name = name(slash + 1, name.Length() - slash - 1);
+            }
+
+            dir->WriteTObject(it.result, name, "WriteDelete");
+            delete it.result;
+
+            ++summary.processed;
+            summary.paths.push_back(it.path);
+        }
+    }
+
+    TH1::AddDirectory(add_dir);
+
+    return summary;
+}
+
+/**
+ * @brief Operation calling calcErrorPropagationMult().
+ */
+DirectoryProcessor::Operation DirectoryProcessor::ErrorPropagationMult(double val, double err)
+{
+    return [=](TH1* h, const TString&) {
+        calcErrorPropagationMult(h, val, err);
+        return h;
+    };
+}
+
+/**
+ * @brief Operation calling calcErrorPropagationDiv().
+ */
+DirectoryProcessor::Operation DirectoryProcessor::ErrorPropagationDiv(double val, double err)
+{
+    return [=](TH1* h, const TString&) {
+        calcErrorPropagationDiv(h, val, err);
+        return h;
+    };
+}
+
+/**
+ * @brief Operation replacing each histogram by makeRelativeErrorHistogram().
+ */
+DirectoryProcessor::Operation DirectoryProcessor::RelativeErrorHistogram(bool percentage)
+{
+    return [=](TH1* h, const TString&) { return makeRelativeErrorHistogram(h, percentage); };
+}
+
+/**
+ * @brief Operation calling copyRelativeErrors() with the histogram of the same path in
+ * errors_source; fails if there is none.
+ */
+DirectoryProcessor::Operation DirectoryProcessor::CopyRelativeErrors(TDirectory* errors_source)
+{
+    auto mtx = std::make_shared<std::mutex>();
+
+    return [=](TH1* h, const TString& path) -> TH1* {
+        TH1* src = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(*mtx);
+            src = dynamic_cast<TH1*>(errors_source->Get(path));
+        }
+        if (!src) return nullptr;
+
+        copyRelativeErrors(h, src);
+        return h;
+    };
+}
@@ -0,0 +1,200 @@
+#include "Efficiency.h"
+
+#include "Parallel.h"
+
+#include <TEfficiency.h>
+#include <TError.h>
+#include <TH1.h>
+#include <TMath.h>
+
+#include <algorithm>
+#include <cmath>
+
+static void NormalKernel(const Double_t* pass, const Double_t* total, size_t n, Double_t z,
+                         Double_t* eff, Double_t* err_low, Double_t* err_high)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        Double_t N = total[i] > 0 ? total[i] : 1.0;
+        Double_t e = total[i] > 0 ? pass[i] / N : 0.0;
+        Double_t s = total[i] > 0 ? z * sqrt(std::max(e * (1.0 - e), 0.0) / N) : 0.0;
+
+        eff[i] = e;
+        err_low[i] = std::min(s, e);
+        err_high[i] = std::min(s, 1.0 - e);
+    }
+}
+
+static void WilsonKernel(const Double_t* pass, const Double_t* total, size_t n, Double_t z,
+                         Double_t* eff, Double_t* err_low, Double_t* err_high)
+{
+    const Double_t z2 = z * z;
+    for (size_t i = 0; i < n; ++i)
+    {
+        Double_t N = total[i] > 0 ? total[i] : 1.0;
+        Double_t k = total[i] > 0 ? pass[i] : 0.0;
+        Double_t e = k / N;
+
+        Double_t denom = N + z2;
+        Double_t center = (k + 0.5 * z2) / denom;
+        Double_t half = z / denom * sqrt(std::max(k * (N - k) / N, 0.0) + 0.25 * z2);
+
+        Double_t lower = total[i] > 0 ? std::max(center - half, 0.0) : 0.0;
+        Double_t upper = total[i] > 0 ? std::min(center + half, 1.0) : 1.0;
+
+        eff[i] = e;
+        err_low[i] = e - lower;
+        err_high[i] = upper - e;
+    }
+}
+
+static void ClopperPearsonKernel(const Double_t* pass, const Double_t* total, size_t n,
+                                 Double_t cl, Double_t* eff, Double_t* err_low,
+                                 Double_t* err_high)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (total[i] <= 0)
+        {
+            eff[i] = 0.0;
+            err_low[i] = 0.0;
+            err_high[i] = 1.0;
+            continue;
+        }
+
+        Double_t e = pass[i] / total[i];
+        eff[i] = e;
+        err_low[i] = e - TEfficiency::ClopperPearson(total[i], pass[i], cl, kFALSE);
+        err_high[i] = TEfficiency::ClopperPearson(total[i], pass[i], cl, kTRUE) - e;
+    }
+}
+
+/**
+ * @brief Efficiencies of n bins.
+ *
+ * @param pass passed counts
+ * @param total total counts
+ * @param n number of bins
+ * @param eff output efficiencies
+ * @param err_low output low errors
+ * @param err_high output high errors
+ * @param interval interval type
+ * @param cl confidence level
+ * @param workers number of threads
+ */
+void RT::CalcEfficiency(const Double_t* pass, const Double_t* total, size_t n, Double_t* eff,
+                        Double_t* err_low, Double_t* err_high, EfficiencyInterval interval,
+                        Double_t cl, UInt_t workers)
+{
+    const Double_t z = TMath::NormQuantile(0.5 * (1.0 + cl));
+
+    auto kernel = [&](size_t first, size_t count) {
+        switch (interval)
+        {
+            case EI_WILSON:
+                WilsonKernel(pass + first, total + first, count, z, eff + first,
+                             err_low + first, err_high + first);
+                break;
+            case EI_CLOPPER_PEARSON:
+                ClopperPearsonKernel(pass + first, total + first, count, cl, eff + first,
+                                     err_low + first, err_high + first);
+                break;
+            default:
+                NormalKernel(pass + first, total + first, count, z, eff + first,
+                             err_low + first, err_high + first);
+                break;
+        }
+    };
+
+    const size_t chunk = 16384;
+    size_t chunks = (n + chunk - 1) / chunk;
+
+    if (workers == 1 or chunks <= 1)
+    {
+        kernel(0, n);
+        return;
+    }
+
+    ParallelFor(chunks, workers, [&](size_t c) {
+        size_t first = c * chunk;
+        kernel(first, std::min(chunk, n - first));
+    });
+}
+
+/**
+ * @brief Copies all cells of the histogram, TH1D/TH2D/TH3D arrays are copied as a whole.
+ */
+static void CellContents(const TH1* h, std::vector<Double_t>& cells)
+{
+    Int_t ncells = h->GetNcells();
+    const TArrayD* arr = dynamic_cast<const TArrayD*>(h);
+    if (arr and arr->GetSize() == ncells)
+    {
+        cells.assign(arr->GetArray(), arr->GetArray() + ncells);
+        return;
+    }
+
+    cells.resize(ncells);
+    for (Int_t bin = 0; bin < ncells; ++bin)
+        cells[bin] = h->GetBinContent(bin);
+}
+
+/**
+ * @brief Efficiency histogram from pass and total histograms.
+ *
+ * @param pass passed counts
+ * @param total total counts
+ * @param eff output histogram with the same binning
+ * @param interval interval type
+ * @param cl confidence level
+ * @param workers number of threads
+ * @param errors if given, filled with the asymmetric errors of all cells
+ * @return false if the histograms have different number of cells
+ */
+Bool_t RT::CalcEfficiency(const TH1* pass, const TH1* total, TH1* eff,
+                          EfficiencyInterval interval, Double_t cl, UInt_t workers,
+                          std::vector<ErrorsPair>* errors)
+{
+    Int_t ncells = eff->GetNcells();
+    if (pass->GetNcells() != ncells or total->GetNcells() != ncells)
+    {
+        Error("CalcEfficiency", "Histograms %s, %s and %s have different binning",
+              pass->GetName(), total->GetName(), eff->GetName());
+        return kFALSE;
+    }
+
+    std::vector<Double_t> p, t;
+    CellContents(pass, p);
+    CellContents(total, t);
+
+    std::vector<Double_t> e(ncells), lo(ncells), hi(ncells);
+    CalcEfficiency(p.data(), t.data(), ncells, e.data(), lo.data(), hi.data(), interval, cl,
+                   workers);
+
+    if (!eff->GetSumw2N()) eff->Sumw2();
+    Double_t* sumw2 = eff->GetSumw2()->GetArray();
+
+    TArrayD* arr = dynamic_cast<TArrayD*>(eff);
+    if (arr and arr->GetSize() == ncells)
+        std::copy(e.begin(), e.end(), arr->GetArray());
+    else
+        for (Int_t bin = 0; bin < ncells; ++bin)
+            eff->SetBinContent(bin, e[bin]);
+
+    for (Int_t bin = 0; bin < ncells; ++bin)
+    {
+        Double_t err = std::max(lo[bin], hi[bin]);
+        sumw2[bin] = err * err;
+    }
+
+    eff->SetEntries(pass->GetEntries());
+
+    if (errors)
+    {
+        errors->resize(ncells);
+        for (Int_t bin = 0; bin < ncells; ++bin)
+            (*errors)[bin] = {hi[bin], lo[bin]};
+    }
+
+    return kTRUE;
+}
@@ -0,0 +1,177 @@
+#include "ErrorBand.h"
+
+#include <TError.h>
+#include <TF1.h>
+
+#include <cmath>
+
+using namespace RT;
+
+// 5-point Gauss-Legendre nodes and weights on [-1, 1]
+static const Double_t gl_nodes[5] = {-0.9061798459386640, -0.5384693101056831, 0.0,
+                                     0.5384693101056831, 0.9061798459386640};
+static const Double_t gl_weights[5] = {0.2369268850561891, 0.4786286704993665,
+                                       0.5688888888888889, 0.4786286704993665,
+                                       0.2369268850561891};
+
+/**
+ * @brief Uses the parameter errors of the function as uncorrelated errors.
+ */
+ErrorBand::ErrorBand(TF1* f)
+    : func(f), npar(f->GetNpar()), pars(npar), grad(npar), igrad(npar)
+{
+    setCovariance();
+}
+
+/**
+ * @param f function
+ * @param cov covariance matrix of the parameters, e.g. TFitResult::GetCovarianceMatrix()
+ */
+ErrorBand::ErrorBand(TF1* f, const TMatrixDSym& cov)
+    : func(f), npar(f->GetNpar()), pars(npar), grad(npar), igrad(npar)
+{
+    setCovariance(cov);
+}
+
+/**
+ * @brief Takes the current parameter errors of the function, without correlations.
+ */
+void ErrorBand::setCovariance()
+{
+    cov.assign(npar * npar, 0.0);
+    steps.assign(npar, 0.0);
+
+    for (Int_t i = 0; i < npar; ++i)
+    {
+        Double_t e = func->GetParError(i);
+        cov[i * npar + i] = e * e;
+        steps[i] = 1e-3 * e;
+    }
+}
+
+void ErrorBand::setCovariance(const TMatrixDSym& m)
+{
+    cov.assign(npar * npar, 0.0);
+    steps.assign(npar, 0.0);
+
+    if (m.GetNrows() != npar)
+    {
+        Error("ErrorBand", "Covariance matrix has %d rows, function %s has %d parameters",
+              m.GetNrows(), func->GetName(), npar);
+        return;
+    }
+
+    for (Int_t i = 0; i < npar; ++i)
+    {
+        for (Int_t j = 0; j < npar; ++j)
+            cov[i * npar + j] = m(i, j);
+
+        if (m(i, i) > 0) steps[i] = 1e-3 * sqrt(m(i, i));
+    }
+}
+
+/**
+ * @brief Evaluates the function and its parameter gradient at x.
+ */
+Double_t ErrorBand::evalGradient(Double_t x, Double_t* g)
+{
+    const Double_t* p = func->GetParameters();
+    pars.assign(p, p + npar);
+
+    for (Int_t j = 0; j < npar; ++j)
+    {
+        if (steps[j] == 0.0)
+        {
+            g[j] = 0.0;
+            continue;
+        }
+
+        pars[j] = p[j] + steps[j];
+        Double_t up = func->EvalPar(&x, pars.data());
+        pars[j] = p[j] - steps[j];
+        Double_t down = func->EvalPar(&x, pars.data());
+        pars[j] = p[j];
+
+        g[j] = (up - down) / (2 * steps[j]);
+    }
+
+    return func->EvalPar(&x, pars.data());
+}
+
+Double_t ErrorBand::propagate(const Double_t* g) const
+{
+    Double_t var = 0.0;
+    for (Int_t i = 0; i < npar; ++i)
+    {
+        if (g[i] == 0.0) continue;
+
+        const Double_t* row = cov.data() + i * npar;
+        Double_t s = 0.0;
+        for (Int_t j = 0; j < npar; ++j)
+            s += row[j] * g[j];
+        var += g[i] * s;
+    }
+
+    return var > 0.0 ? sqrt(var) : 0.0;
+}
+
+/**
+ * @brief Function values and their errors at the given points.
+ *
+ * @param x points
+ * @param n number of points
+ * @param value output function values
+ * @param error output errors
+ */
+void ErrorBand::band(const Double_t* x, size_t n, Double_t* value, Double_t* error)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        value[i] = evalGradient(x[i], grad.data());
+        error[i] = propagate(grad.data());
+    }
+}
+
+/**
+ * @brief Band on n equidistant points from xmin to xmax, both included.
+ *
+ * @param x output points
+ */
+void ErrorBand::band(Double_t xmin, Double_t xmax, size_t n, Double_t* x, Double_t* value,
+                     Double_t* error)
+{
+    Double_t dx = n > 1 ? (xmax - xmin) / (n - 1) : 0.0;
+    for (size_t i = 0; i < n; ++i)
+        x[i] = xmin + i * dx;
+
+    band(x, n, value, error);
+}
+
+/**
+ * @brief Integral of the function and its error, with a 5-point Gauss-Legendre rule on each of
+ * the nintervals.
+ *
+ * @return pair of integral and error
+ */
+std::pair<double, double> ErrorBand::integral(Double_t l, Double_t u, Int_t nintervals)
+{
+    if (nintervals < 1) nintervals = 1;
+
+    igrad.assign(npar, 0.0);
+    Double_t h = (u - l) / nintervals;
+    Double_t sum = 0.0;
+
+    for (Int_t i = 0; i < nintervals; ++i)
+    {
+        Double_t mid = l + (i + 0.5) * h;
+        for (int k = 0; k < 5; ++k)
+        {
+            Double_t w = 0.5 * h * gl_weights[k];
+            sum += w * evalGradient(mid + 0.5 * h * gl_nodes[k], grad.data());
+            for (Int_t j = 0; j < npar; ++j)
+                igrad[j] += w * grad[j];
+        }
+    }
+
+    return std::pair<double, double>(sum, propagate(igrad.data()));
+}
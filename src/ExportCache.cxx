@@ -0,0 +1,132 @@
+#include "ExportCache.h"
+
+#include "RootTools.h"
+
+#include <TBufferFile.h>
+#include <TCanvas.h>
+#include <TStyle.h>
+#include <TSystem.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace RT::Exports;
+
+const char* ExportCache::manifest_name = ".rt_export_manifest";
+
+/**
+ * @brief 64-bit FNV-1a hash, continued from the given seed.
+ */
+static ULong64_t fnv1a(const void* data, size_t size, ULong64_t seed = 0xcbf29ce484222325ULL)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    ULong64_t hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+ExportCache::ExportCache(const TString& path)
+    : path(path), modified(false), cnt_exported(0), cnt_skipped(0)
+{
+    load();
+}
+
+ExportCache::~ExportCache() { save(); }
+
+ULong64_t ExportCache::digest(TCanvas* can)
+{
+    std::vector<char> blob = SerializeCanvas(can);
+    ULong64_t hash = fnv1a(blob.data(), blob.size());
+
+    TBufferFile buf(TBuffer::kWrite);
+    buf.WriteObject(gStyle);
+    hash = fnv1a(buf.Buffer(), buf.Length(), hash);
+
+    char formats[3] = {(char)gImgExportPNG, (char)gImgExportEPS, (char)gImgExportPDF};
+    return fnv1a(formats, sizeof(formats), hash);
+}
+
+/**
+ * @brief Exports the canvas images unless the canvas did not change since the last export.
+ *
+ * @param can canvas to export
+ * @return true if the images were exported, false if skipped
+ */
+Bool_t ExportCache::exportImages(TCanvas* can)
+{
+    if (!gHasImgExportEnabled) return kFALSE;
+
+    ULong64_t d = digest(can);
+    std::string name = can->GetName();
+
+    auto it = entries.find(name);
+    if (it != entries.end() and it->second == d and filesExist(can))
+    {
+        ++cnt_skipped;
+        return kFALSE;
+    }
+
+    ExportImages(can, path);
+    entries[name] = d;
+    modified = true;
+    ++cnt_exported;
+
+    return kTRUE;
+}
+
+/**
+ * @brief Writes the manifest if any entry changed. Called also by the destructor.
+ */
+void ExportCache::save()
+{
+    if (!modified) return;
+
+    TString fname = path + manifest_name;
+    std::ofstream ofs(fname.Data());
+    if (!ofs.is_open())
+    {
+        perror(fname.Data());
+        return;
+    }
+
+    char hex[17];
+    for (const auto& e : entries)
+    {
+        snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)e.second);
+        ofs << hex << "\t" << e.first << "\n";
+    }
+
+    modified = false;
+}
+
+void ExportCache::load()
+{
+    TString fname = path + manifest_name;
+    std::ifstream ifs(fname.Data());
+    if (!ifs.is_open()) return;
+
+    // digest, tab, canvas name up to the end of the line; names may contain spaces
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos) continue;
+
+        entries[line.substr(tab + 1)] = strtoull(line.substr(0, tab).c_str(), nullptr, 16);
+    }
+}
+
+Bool_t ExportCache::filesExist(TCanvas* can) const
+{
+    if (gImgExportPNG and gSystem->AccessPathName(path + can->GetName() + ".png")) return kFALSE;
+    if (gImgExportEPS and gSystem->AccessPathName(path + can->GetName() + ".eps")) return kFALSE;
+    if (gImgExportPDF and gSystem->AccessPathName(path + can->GetName() + ".pdf")) return kFALSE;
+
+    return kTRUE;
+}
@@ -0,0 +1,310 @@
+#include "FileAccessor.h"
+
+#include <TDirectory.h>
+#include <TError.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TKey.h>
+#include <TList.h>
+
+#include <algorithm>
+
+using namespace RT;
+
+size_t FileAccessor::coalesce_gap = 64 * 1024;
+size_t FileAccessor::coalesce_max = 16 * 1024 * 1024;
+
+/**
+ * @brief Uses an already opened file, the file is not closed by the accessor.
+ *
+ * @param f source file
+ * @param budget memory budget of the cache in bytes
+ */
+FileAccessor::FileAccessor(TFile* f, size_t budget)
+    : file(f), owner(false), budget(budget), memory(0), batch(0), cnt_hits(0), cnt_reads(0),
+      cnt_requests(0)
+{
+    if (!file or file->IsZombie())
+    {
+        file = nullptr;
+        return;
+    }
+
+    buildIndex(file, "");
+}
+
+/**
+ * @brief Opens the file for reading, the file is closed with the accessor.
+ *
+ * @param filename file name
+ * @param budget memory budget of the cache in bytes
+ */
+FileAccessor::FileAccessor(const TString& filename, size_t budget)
+    : FileAccessor((TFile*)nullptr, budget)
+{
+    TFile* f = TFile::Open(filename, "READ");
+    if (!f or f->IsZombie())
+    {
+        Error("FileAccessor", "Can't open file %s", filename.Data());
+        delete f;
+        return;
+    }
+
+    file = f;
+    owner = true;
+
+    buildIndex(file, "");
+}
+
+FileAccessor::~FileAccessor()
+{
+    clear();
+
+    if (owner)
+    {
+        file->Close();
+        delete file;
+    }
+}
+
+/**
+ * @brief Indexes the keys of the directory and of its subdirectories, only the highest cycle of
+ * each key is used.
+ */
+void FileAccessor::buildIndex(TDirectory* dir, const TString& prefix)
+{
+    TIter next(dir->GetListOfKeys());
+    TKey* key = nullptr;
+    while ((key = (TKey*)next()))
+    {
+        TString name = prefix + key->GetName();
+
+        if (TString(key->GetClassName()).BeginsWith("TDirectory"))
+        {
+            TDirectory* sub = dir->GetDirectory(key->GetName());
+            if (sub) buildIndex(sub, name + "/");
+            continue;
+        }
+
+        auto it = index.find(name.Data());
+        if (it != index.end() and it->second.key->GetCycle() >= key->GetCycle()) continue;
+
+        Entry& e = index[name.Data()];
+        e.key = key;
+        e.obj = nullptr;
+        e.size = key->GetObjlen() + key->GetKeylen();
+        e.batch = 0;
+    }
+}
+
+Bool_t FileAccessor::has(const TString& name) const
+{
+    return index.find(name.Data()) != index.end();
+}
+
+/**
+ * @brief Indexed keys ordered by their position in the file.
+ */
+auto FileAccessor::getIndex() const -> std::vector<KeyInfo>
+{
+    typedef std::pair<Long64_t, KeyInfo> SeekInfo;
+
+    std::vector<SeekInfo> keys;
+    for (const auto& it : index)
+    {
+        const TKey* key = it.second.key;
+        keys.push_back({key->GetSeekKey(), {it.first, key->GetClassName(), it.second.size}});
+    }
+
+    std::sort(keys.begin(), keys.end(),
+              [](const SeekInfo& a, const SeekInfo& b) { return a.first < b.first; });
+
+    std::vector<KeyInfo> infos;
+    for (auto& k : keys)
+        infos.push_back(k.second);
+
+    return infos;
+}
+
+FileAccessor::Entry* FileAccessor::find(const TString& name)
+{
+    auto it = index.find(name.Data());
+    if (it == index.end()) return nullptr;
+
+    return &it->second;
+}
+
+/**
+ * @brief Returns the object, reads it from the file if not cached.
+ *
+ * @param name object name, "dir/name" for objects in subdirectories
+ * @return the object owned by the accessor, nullptr if missing or unreadable
+ */
+TObject* FileAccessor::get(const TString& name)
+{
+    std::vector<TObject*> objects;
+    get(std::vector<TString>{name}, objects);
+
+    return objects[0];
+}
+
+/**
+ * @brief Returns many objects at once. Objects not in the cache are read in the order of their
+ * position in the file, neighbouring keys are read with a single request.
+ *
+ * Objects of one call are never evicted by the same call, even if they exceed the budget.
+ *
+ * @param names object names
+ * @param objects the objects in order of names, nullptr for missing or unreadable ones
+ * @return number of missing or unreadable objects
+ */
+size_t FileAccessor::get(const std::vector<TString>& names, std::vector<TObject*>& objects)
+{
+    ++batch;
+
+    std::vector<Entry*> entries(names.size(), nullptr);
+    std::vector<Entry*> to_read;
+
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        Entry* e = find(names[i]);
+        entries[i] = e;
+        if (!e) continue;
+
+        if (e->obj)
+        {
+            ++cnt_hits;
+            touch(e);
+        }
+        else if (e->batch != batch)
+            to_read.push_back(e);
+
+        e->batch = batch;
+    }
+
+    if (!to_read.empty()) readBatch(to_read);
+
+    evict();
+
+    size_t missing = 0;
+    objects.resize(names.size());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        objects[i] = entries[i] ? entries[i]->obj : nullptr;
+        if (!objects[i]) ++missing;
+    }
+
+    return missing;
+}
+
+/**
+ * @brief Reads the keys sorted by their position in the file. Keys separated by at most
+ * coalesce_gap bytes are fetched with one read and deserialized from that buffer.
+ */
+void FileAccessor::readBatch(std::vector<Entry*>& entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+        return a->key->GetSeekKey() < b->key->GetSeekKey();
+    });
+
+    std::vector<char> buffer;
+
+    size_t first = 0;
+    while (first < entries.size())
+    {
+        Long64_t start = entries[first]->key->GetSeekKey();
+        Long64_t end = start + entries[first]->key->GetNbytes();
+
+        size_t last = first + 1;
+        for (; last < entries.size(); ++last)
+        {
+            Long64_t seek = entries[last]->key->GetSeekKey();
+            Long64_t seek_end = seek + entries[last]->key->GetNbytes();
+
+            if (seek - end > (Long64_t)coalesce_gap) break;
+            if (seek_end - start > (Long64_t)coalesce_max) break;
+            if (seek_end > end) end = seek_end;
+        }
+
+        buffer.resize(end - start);
+        ++cnt_requests;
+
+        if (file->ReadBuffer(buffer.data(), start, end - start))
+        {
+            Error("FileAccessor", "Can't read %lld bytes at %lld from file %s", end - start,
+                  start, file->GetName());
+        }
+        else
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                TKey* key = entries[i]->key;
+                store(entries[i], key->ReadObjWithBuffer(&buffer[key->GetSeekKey() - start]));
+            }
+        }
+
+        first = last;
+    }
+}
+
+void FileAccessor::store(Entry* e, TObject* obj)
+{
+    if (!obj)
+    {
+        Error("FileAccessor", "Can't read %s from file %s", e->key->GetName(), file->GetName());
+        return;
+    }
+
+    if (obj->InheritsFrom(TH1::Class())) ((TH1*)obj)->SetDirectory(nullptr);
+
+    ++cnt_reads;
+
+    e->obj = obj;
+    memory += e->size;
+
+    lru.push_front(e);
+    e->lru = lru.begin();
+}
+
+void FileAccessor::touch(Entry* e) { lru.splice(lru.begin(), lru, e->lru); }
+
+/**
+ * @brief Deletes the least recently used objects until the cache fits into the budget. Objects
+ * used by the current call are kept.
+ */
+void FileAccessor::evict()
+{
+    while (memory > budget and !lru.empty())
+    {
+        Entry* e = lru.back();
+        if (e->batch == batch) break;
+
+        lru.pop_back();
+        memory -= e->size;
+
+        delete e->obj;
+        e->obj = nullptr;
+    }
+}
+
+void FileAccessor::setBudget(size_t b)
+{
+    budget = b;
+    ++batch;
+    evict();
+}
+
+/**
+ * @brief Deletes all cached objects, the index is kept.
+ */
+void FileAccessor::clear()
+{
+    for (Entry* e : lru)
+    {
+        delete e->obj;
+        e->obj = nullptr;
+    }
+
+    lru.clear();
+    memory = 0;
+}
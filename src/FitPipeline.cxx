@@ -0,0 +1,232 @@
+#include "FitPipeline.h"
+
+#include "Parallel.h"
+#include "RootTools.h"
+
+#include <TError.h>
+#include <TF1.h>
+#include <TH1.h>
+
+#include <mutex>
+
+using namespace RT;
+
+/**
+ * @param model fit model, used as start for the first fits
+ * @param workers number of threads, 0 for one per CPU
+ */
+FitPipeline::FitPipeline(const TF1* model, UInt_t workers)
+    : model(model), signal(nullptr), signal_offset(0), workers(GetWorkers(workers)),
+      fit_options("QNR"), waves(0)
+{
+    EnableThreadSafety();
+}
+
+/**
+ * @brief Adds a slice at the grid position, positions must be unique.
+ *
+ * @return slice index
+ */
+size_t FitPipeline::addSlice(TH1* h, Int_t ix, Int_t iy)
+{
+    SliceFit s;
+    s.hist = h;
+    s.integral = 0;
+    s.ix = ix;
+    s.iy = iy;
+    s.fitted = false;
+    s.status = -1;
+    s.seed = -1;
+    s.chi2 = 0;
+    s.ndf = 0;
+    s.has_info = false;
+    s.mean = 0;
+    s.width = 0;
+
+    if (!grid.insert({{ix, iy}, slices.size()}).second)
+        Warning("FitPipeline", "Slice at [%d, %d] already exists", ix, iy);
+
+    slices.push_back(s);
+    return slices.size() - 1;
+}
+
+/**
+ * @brief Sets the signal part of the model, used for the mean and width of the slices.
+ *
+ * @param sig signal function, its parameters are the model ones from offset on; nullptr to use
+ * the model
+ * @param offset first model parameter of the signal
+ * @return false if the model has not enough parameters, the signal is not changed then
+ */
+bool FitPipeline::setSignal(const TF1* sig, Int_t offset)
+{
+    if (sig and (offset < 0 or offset + sig->GetNpar() > model->GetNpar()))
+    {
+        Error("FitPipeline", "Signal %s needs parameters %d to %d, model %s has %d", sig->GetName(),
+              offset, offset + sig->GetNpar() - 1, model->GetName(), model->GetNpar());
+        return false;
+    }
+
+    signal = sig;
+    signal_offset = offset;
+    return true;
+}
+
+/**
+ * @brief Converged neighbour with the most entries, -1 if there is none.
+ */
+long FitPipeline::bestNeighbour(size_t i) const
+{
+    static const Int_t dirs[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+
+    long best = -1;
+    for (const auto& d : dirs)
+    {
+        auto it = grid.find({slices[i].ix + d[0], slices[i].iy + d[1]});
+        if (it == grid.end()) continue;
+
+        const SliceFit& n = slices[it->second];
+        if (!n.fitted or n.status != 0) continue;
+
+        if (best < 0 or n.integral > slices[best].integral) best = it->second;
+    }
+
+    return best;
+}
+
+/**
+ * @brief Fits all slices which were not fitted yet.
+ *
+ * @return number of converged fits, 0 without fitting if Minuit2 is not available
+ */
+size_t FitPipeline::run()
+{
+    if (!HasMinimizer("Minuit2"))
+    {
+        Error("FitPipeline", "Minuit2 is not available, no slices were fitted");
+        return 0;
+    }
+
+    size_t nslices = slices.size();
+    for (auto& s : slices)
+        s.integral = s.hist->Integral();
+
+    // pool of private function copies, made by this thread
+    std::vector<TF1*> pool;
+    std::mutex pool_mtx;
+    for (UInt_t w = 0; w < workers; ++w)
+        pool.push_back((TF1*)model->Clone());
+    TF1* sig = signal ? (TF1*)signal->Clone() : nullptr;
+
+    Int_t npar = model->GetNpar();
+    std::vector<size_t> wave;
+    std::vector<long> seeds;
+    while (true)
+    {
+        wave.clear();
+        seeds.clear();
+
+        for (size_t i = 0; i < nslices; ++i)
+        {
+            if (slices[i].fitted) continue;
+
+            long nb = bestNeighbour(i);
+            if (nb < 0) continue;
+
+            wave.push_back(i);
+            seeds.push_back(nb);
+        }
+
+        if (wave.empty())
+        {
+            long largest = -1;
+            for (size_t i = 0; i < nslices; ++i)
+                if (!slices[i].fitted and
+                    (largest < 0 or slices[i].integral > slices[largest].integral))
+                    largest = i;
+
+            if (largest < 0) break;
+
+            wave.push_back(largest);
+            seeds.push_back(-1);
+        }
+
+        ++waves;
+
+        // seeds are read before the wave, so the order of the fits within it does not matter
+        std::vector<std::vector<double>> start(wave.size()), start_err(wave.size());
+        for (size_t k = 0; k < wave.size(); ++k)
+        {
+            if (seeds[k] < 0) continue;
+            start[k] = slices[seeds[k]].params;
+            start_err[k] = slices[seeds[k]].errors;
+        }
+
+        ParallelFor(wave.size(), workers, [&](size_t k) {
+            TF1* f = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(pool_mtx);
+                f = pool.back();
+                pool.pop_back();
+            }
+
+            SliceFit& s = slices[wave[k]];
+            s.seed = seeds[k];
+
+            Int_t status = -1;
+            if (s.seed >= 0)
+            {
+                f->SetParameters(start[k].data());
+                f->SetParErrors(start_err[k].data());
+                status = FitWithMinimizer(s.hist, f, fit_options, "Minuit2");
+            }
+            if (status != 0)
+            {
+                // cold start from the model
+                s.seed = -1;
+                f->SetParameters(model->GetParameters());
+                f->SetParErrors(model->GetParErrors());
+                status = FitWithMinimizer(s.hist, f, fit_options, "Minuit2");
+            }
+
+            s.fitted = true;
+            s.status = status;
+            s.params.assign(f->GetParameters(), f->GetParameters() + npar);
+            s.errors.assign(f->GetParErrors(), f->GetParErrors() + npar);
+            s.chi2 = f->GetChisquare();
+            s.ndf = f->GetNDF();
+
+            std::lock_guard<std::mutex> lock(pool_mtx);
+            pool.push_back(f);
+        });
+
+        // mean and width use the shared signal copy, so they are taken here
+        for (size_t i : wave)
+        {
+            SliceFit& s = slices[i];
+            if (s.status != 0) continue;
+
+            if (sig)
+            {
+                for (Int_t j = 0; j < sig->GetNpar(); ++j)
+                    sig->SetParameter(j, s.params[signal_offset + j]);
+                s.has_info = calcFitInfo(sig, s.mean, s.width);
+            }
+            else
+            {
+                pool.back()->SetParameters(s.params.data());
+                s.has_info = calcFitInfo(pool.back(), s.mean, s.width);
+            }
+        }
+    }
+
+    for (TF1* f : pool)
+        delete f;
+    delete sig;
+
+    size_t converged = 0;
+    for (const auto& s : slices)
+        if (s.fitted and s.status == 0) ++converged;
+
+    return converged;
+}
@@ -0,0 +1,235 @@
+#include "GraphDecimation.h"
+
+#include <TAxis.h>
+#include <TGraph.h>
+#include <TGraphAsymmErrors.h>
+#include <TGraphErrors.h>
+#include <TString.h>
+#include <TVirtualPad.h>
+
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+static void MinMaxColumns(const Double_t* x, const Double_t* y, const Double_t* lo,
+                          const Double_t* hi, Int_t n, UInt_t columns, Bool_t logx,
+                          std::vector<bool>& keep)
+{
+    Double_t xmin = FLT_MAX;
+    Double_t xmax = -FLT_MAX;
+    for (Int_t i = 0; i < n; ++i)
+    {
+        if (logx and x[i] <= 0) continue;
+        Double_t tx = logx ? log10(x[i]) : x[i];
+        if (tx < xmin) xmin = tx;
+        if (tx > xmax) xmax = tx;
+    }
+    if (xmax <= xmin) xmax = xmin + 1.0;
+
+    const Int_t none = -1;
+    std::vector<Int_t> first(columns, none), last(columns, none);
+    std::vector<Int_t> lowest(columns, none), highest(columns, none);
+    std::vector<Int_t> ymin(columns, none), ymax(columns, none);
+
+    for (Int_t i = 0; i < n; ++i)
+    {
+        if (logx and x[i] <= 0)
+        {
+            keep[i] = true;
+            continue;
+        }
+
+        Double_t tx = logx ? log10(x[i]) : x[i];
+        UInt_t c = (tx - xmin) / (xmax - xmin) * columns;
+        if (c >= columns) c = columns - 1;
+
+        if (first[c] == none) first[c] = i;
+        last[c] = i;
+        if (lowest[c] == none or lo[i] < lo[lowest[c]]) lowest[c] = i;
+        if (highest[c] == none or hi[i] > hi[highest[c]]) highest[c] = i;
+        if (ymin[c] == none or y[i] < y[ymin[c]]) ymin[c] = i;
+        if (ymax[c] == none or y[i] > y[ymax[c]]) ymax[c] = i;
+    }
+
+    for (UInt_t c = 0; c < columns; ++c)
+    {
+        if (first[c] == none) continue;
+        keep[first[c]] = true;
+        keep[last[c]] = true;
+        keep[lowest[c]] = true;
+        keep[highest[c]] = true;
+        keep[ymin[c]] = true;
+        keep[ymax[c]] = true;
+    }
+}
+
+static void LargestTriangleThreeBuckets(const Double_t* x, const Double_t* y, Int_t n,
+                                        UInt_t threshold, Bool_t logx, std::vector<bool>& keep)
+{
+    // with log x, points at x <= 0 have no position; they are kept and not bucketed
+    std::vector<Int_t> idx;
+    idx.reserve(n);
+    for (Int_t i = 0; i < n; ++i)
+    {
+        if (logx and x[i] <= 0)
+            keep[i] = true;
+        else
+            idx.push_back(i);
+    }
+
+    Int_t m = idx.size();
+    if (threshold < 3 or threshold >= (UInt_t)m)
+    {
+        for (Int_t k : idx)
+            keep[k] = true;
+        return;
+    }
+
+    auto tx = [&](Int_t k) { return logx ? log10(x[idx[k]]) : x[idx[k]]; };
+    auto ty = [&](Int_t k) { return y[idx[k]]; };
+
+    Double_t every = Double_t(m - 2) / (threshold - 2);
+
+    Int_t a = 0;
+    keep[idx[a]] = true;
+
+    for (UInt_t b = 0; b < threshold - 2; ++b)
+    {
+        Int_t avg_start = Int_t((b + 1) * every) + 1;
+        Int_t avg_end = Int_t((b + 2) * every) + 1;
+        if (avg_end > m) avg_end = m;
+
+        Double_t avg_x = 0.0;
+        Double_t avg_y = 0.0;
+        for (Int_t k = avg_start; k < avg_end; ++k)
+        {
+            avg_x += tx(k);
+            avg_y += ty(k);
+        }
+        Int_t avg_len = avg_end - avg_start;
+        if (avg_len > 0)
+        {
+            avg_x /= avg_len;
+            avg_y /= avg_len;
+        }
+
+        Int_t range_start = Int_t(b * every) + 1;
+        Int_t range_end = Int_t((b + 1) * every) + 1;
+
+        Double_t max_area = -1.0;
+        Int_t next_a = range_start;
+        for (Int_t k = range_start; k < range_end; ++k)
+        {
+            Double_t area =
+                fabs((tx(a) - avg_x) * (ty(k) - ty(a)) - (tx(a) - tx(k)) * (avg_y - ty(a)));
+            if (area > max_area)
+            {
+                max_area = area;
+                next_a = k;
+            }
+        }
+
+        keep[idx[next_a]] = true;
+        a = next_a;
+    }
+
+    keep[idx[m - 1]] = true;
+}
+
+/**
+ * @brief Decimates the graph to about `columns` horizontal bins.
+ *
+ * @param gr source graph
+ * @param columns number of columns, usually the pixel width of the pad frame
+ * @param mode decimation algorithm
+ * @param logx columns are equidistant in log x
+ * @return new graph, owned by the caller
+ */
+TGraph* RT::DecimateGraph(const TGraph* gr, UInt_t columns, DecimationMode mode, Bool_t logx)
+{
+    Int_t n = gr->GetN();
+    const Double_t* x = gr->GetX();
+    const Double_t* y = gr->GetY();
+    const Double_t* exl = gr->GetEXlow();
+    const Double_t* exh = gr->GetEXhigh();
+    const Double_t* eyl = gr->GetEYlow();
+    const Double_t* eyh = gr->GetEYhigh();
+
+    if (columns < 1) columns = 1;
+
+    std::vector<Double_t> lo(n), hi(n);
+    for (Int_t i = 0; i < n; ++i)
+    {
+        lo[i] = y[i] - (eyl ? eyl[i] : 0.0);
+        hi[i] = y[i] + (eyh ? eyh[i] : 0.0);
+    }
+
+    std::vector<bool> keep(n, false);
+    if (mode == DM_LTTB)
+        LargestTriangleThreeBuckets(x, y, n, 2 * columns, logx, keep);
+    else
+        MinMaxColumns(x, y, lo.data(), hi.data(), n, columns, logx, keep);
+
+    // the extremes are always kept, with and without error bars
+    if (n > 0)
+    {
+        Int_t imin = 0;
+        Int_t imax = 0;
+        Int_t iymin = 0;
+        Int_t iymax = 0;
+        for (Int_t i = 1; i < n; ++i)
+        {
+            if (lo[i] < lo[imin]) imin = i;
+            if (hi[i] > hi[imax]) imax = i;
+            if (y[i] < y[iymin]) iymin = i;
+            if (y[i] > y[iymax]) iymax = i;
+        }
+        keep[imin] = true;
+        keep[imax] = true;
+        keep[iymin] = true;
+        keep[iymax] = true;
+    }
+
+    std::vector<Double_t> dx, dy, dexl, dexh, deyl, deyh;
+    for (Int_t i = 0; i < n; ++i)
+    {
+        if (!keep[i]) continue;
+
+        dx.push_back(x[i]);
+        dy.push_back(y[i]);
+        dexl.push_back(exl ? exl[i] : 0.0);
+        dexh.push_back(exh ? exh[i] : 0.0);
+        deyl.push_back(eyl ? eyl[i] : 0.0);
+        deyh.push_back(eyh ? eyh[i] : 0.0);
+    }
+
+    Int_t dn = dx.size();
+    TGraph* out = nullptr;
+    if (gr->InheritsFrom(TGraphErrors::Class()))
+        out = new TGraphErrors(dn, dx.data(), dy.data(), dexl.data(), deyl.data());
+    else if (eyl or eyh or exl or exh)
+        out = new TGraphAsymmErrors(dn, dx.data(), dy.data(), dexl.data(), dexh.data(),
+                                    deyl.data(), deyh.data());
+    else
+        out = new TGraph(dn, dx.data(), dy.data());
+
+    out->SetName(TString::Format("%s_dec", gr->GetName()));
+    out->SetTitle(gr->GetTitle());
+
+    gr->TAttLine::Copy(*out);
+    gr->TAttFill::Copy(*out);
+    gr->TAttMarker::Copy(*out);
+
+    return out;
+}
+
+/**
+ * @brief Decimates the graph to the pixel width of the pad frame, honours log x of the pad.
+ */
+TGraph* RT::DecimateGraph(const TGraph* gr, TVirtualPad* pad, DecimationMode mode)
+{
+    Double_t w = pad->GetWw() * pad->GetAbsWNDC();
+    UInt_t columns = w * (1.0 - pad->GetLeftMargin() - pad->GetRightMargin());
+
+    return DecimateGraph(gr, columns, mode, pad->GetLogx());
+}
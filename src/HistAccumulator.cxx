@@ -0,0 +1,168 @@
+#include "HistAccumulator.h"
+
+#include "Parallel.h"
+
+#include <TError.h>
+
+#include <cstdlib>
+
+using namespace RT;
+
+static const size_t cache_line = 64;
+
+static void* AllocateAligned(size_t size)
+{
+    void* mem = nullptr;
+    if (posix_memalign(&mem, cache_line, size)) return nullptr;
+
+    return mem;
+}
+
+/**
+ * @param model histogram to copy for every slot, it is not modified
+ * @param slots number of slots, the maximal number of filling threads; 0 for one per CPU
+ * @param buffer_size fills queued per slot before they are passed to the histogram, 0 to fill
+ * directly
+ */
+HistAccumulator::HistAccumulator(const TH1* model, UInt_t slots, size_t buffer_size)
+    : slots(nullptr), nslots(GetWorkers(slots)), buffers(nullptr), buffer_size(buffer_size),
+      next_slot(0), overflow(nullptr)
+{
+    EnableThreadSafety();
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+
+    this->model = (TH1*)model->Clone();
+    this->model->Reset();
+
+    // each buffer is rounded up to whole cache lines
+    size_t buffer_stride = (3 * buffer_size * sizeof(Double_t) + cache_line - 1) / cache_line *
+                           cache_line / sizeof(Double_t);
+
+    this->slots = (Slot*)AllocateAligned(nslots * sizeof(Slot));
+    if (buffer_size)
+        buffers = (Double_t*)AllocateAligned(nslots * buffer_stride * sizeof(Double_t));
+    if (!this->slots or (buffer_size and !buffers))
+    {
+        Error("HistAccumulator", "Can't allocate %u slots, all fills are serialized", nslots);
+        free(this->slots);
+        free(buffers);
+        this->slots = nullptr;
+        buffers = nullptr;
+        nslots = 0;
+    }
+
+    for (UInt_t i = 0; i < nslots; ++i)
+    {
+        Slot& s = this->slots[i];
+        s.h = (TH1*)this->model->Clone();
+        s.buffer = buffers ? buffers + i * buffer_stride : nullptr;
+        s.queued = 0;
+    }
+    overflow = (TH1*)this->model->Clone();
+
+    TH1::AddDirectory(add_dir);
+}
+
+HistAccumulator::~HistAccumulator()
+{
+    for (UInt_t i = 0; i < nslots; ++i)
+        delete slots[i].h;
+    free(slots);
+    free(buffers);
+    delete overflow;
+    delete model;
+}
+
+/**
+ * @brief Takes the next free slot, to be called once by each filling thread.
+ *
+ * @return slot number, getSlots() for the shared overflow slot if all slots are taken
+ */
+UInt_t HistAccumulator::acquire()
+{
+    UInt_t slot = next_slot++;
+    if (slot >= nslots)
+    {
+        Warning("HistAccumulator", "All %u slots are taken, fills of this thread are serialized",
+                nslots);
+        return nslots;
+    }
+
+    return slot;
+}
+
+void HistAccumulator::flush(Slot& s)
+{
+    // FillN takes the number of fills, it steps through the arrays with the stride
+    Int_t n = s.queued / 3;
+    if (!n) return;
+
+    const Double_t* b = s.buffer;
+    if (s.h->GetDimension() == 1)
+        s.h->FillN(n, b, b + 2, 3);
+    else
+        ((TH2*)s.h)->FillN(n, b, b + 1, b + 2, 3);
+
+    s.queued = 0;
+}
+
+void HistAccumulator::fillOverflow(Double_t x, Double_t y, Double_t w, bool xy)
+{
+    std::lock_guard<std::mutex> lock(overflow_mtx);
+    if (xy)
+        ((TH2*)overflow)->Fill(x, y, w);
+    else
+        overflow->Fill(x, w);
+}
+
+/**
+ * @brief Sums all slots, must be called when no thread is filling. The slots are cleared and
+ * released, so the accumulator can be used again.
+ *
+ * @return new histogram owned by the caller
+ */
+TH1* HistAccumulator::merge()
+{
+    ParallelFor(nslots, nslots, [&](size_t i) { flush(slots[i]); });
+
+    for (size_t stride = 1; stride < nslots; stride *= 2)
+    {
+        size_t pairs = (nslots - stride + 2 * stride - 1) / (2 * stride);
+
+        ParallelFor(pairs, nslots, [&](size_t p) {
+            TH1* dst = slots[2 * stride * p].h;
+            TH1* src = slots[2 * stride * p + stride].h;
+            dst->Add(src);
+        });
+    }
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+
+    TH1* result = nullptr;
+    if (nslots)
+    {
+        result = slots[0].h;
+        if (overflow->GetEntries() > 0)
+        {
+            result->Add(overflow);
+            overflow->Reset();
+        }
+        slots[0].h = (TH1*)model->Clone();
+
+        ParallelFor(nslots - 1, nslots, [&](size_t i) { slots[i + 1].h->Reset(); });
+    }
+    else
+    {
+        // the slots could not be allocated, all fills went to the overflow slot
+        result = overflow;
+        overflow = (TH1*)model->Clone();
+    }
+
+    TH1::AddDirectory(add_dir);
+    next_slot = 0;
+
+    return result;
+}
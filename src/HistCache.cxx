@@ -0,0 +1,366 @@
+#include "HistCache.h"
+
+#include "RootTools.h"
+
+#include <TError.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace RT;
+
+static const char cache_magic[8] = {'R', 'T', 'H', 'C', 'A', 'C', 'H', '1'};
+
+/**
+ * @brief Layout of the cache file, all offsets are in bytes from the file begin and aligned to 8.
+ */
+struct CacheHeader
+{
+    char magic[8];
+    Int_t dim;
+    Int_t nbins[3];
+    Int_t variable[3];
+    Int_t has_sumw2;
+    Double_t entries;
+    ULong64_t name_off;
+    ULong64_t title_off;
+    ULong64_t edges_off[3];
+    ULong64_t contents_off;
+    ULong64_t sumw2_off;
+    ULong64_t total_size;
+};
+
+static inline ULong64_t Align8(ULong64_t off) { return (off + 7) & ~7ULL; }
+
+// an array of len bytes at off lies within a mapping of size bytes
+static inline bool InMapping(ULong64_t off, ULong64_t len, ULong64_t size)
+{
+    return off <= size and len <= size - off;
+}
+
+// a NUL-terminated string at off lies within the mapping
+static inline bool StringInMapping(const char* base, ULong64_t off, ULong64_t size)
+{
+    return off < size and memchr(base + off, 0, size - off) != nullptr;
+}
+
+/**
+ * @brief Checks that all arrays and strings of the cache lie within the mapped file, so a corrupt
+ * or truncated file can not give reads out of it.
+ */
+static bool IsValidCache(const char* base, ULong64_t size)
+{
+    const CacheHeader* hdr = (const CacheHeader*)base;
+    if (memcmp(hdr->magic, cache_magic, sizeof(cache_magic)) or hdr->total_size != size)
+        return false;
+
+    if (hdr->dim < 1 or hdr->dim > 3 or (hdr->has_sumw2 != 0 and hdr->has_sumw2 != 1))
+        return false;
+
+    const ULong64_t max_doubles = size / sizeof(Double_t);
+    ULong64_t ncells = 1;
+    for (int a = 0; a < 3; ++a)
+    {
+        if (hdr->nbins[a] < 1 or (ULong64_t)hdr->nbins[a] >= max_doubles) return false;
+        if (hdr->edges_off[a] % 8 or
+            !InMapping(hdr->edges_off[a], (hdr->nbins[a] + 1) * sizeof(Double_t), size))
+            return false;
+
+        // axes above the dimension have no under- and overflow
+        ULong64_t cells = a < hdr->dim ? hdr->nbins[a] + 2 : 1;
+        if (ncells > max_doubles / cells) return false;
+        ncells *= cells;
+    }
+    if (ncells > (ULong64_t)kMaxInt) return false;
+
+    if (hdr->contents_off % 8 or !InMapping(hdr->contents_off, ncells * sizeof(Double_t), size))
+        return false;
+    if (hdr->has_sumw2 and
+        (hdr->sumw2_off % 8 or !InMapping(hdr->sumw2_off, ncells * sizeof(Double_t), size)))
+        return false;
+
+    return StringInMapping(base, hdr->name_off, size) and
+           StringInMapping(base, hdr->title_off, size);
+}
+
+/**
+ * @brief Cache file was modified not before the source file, with nanosecond resolution. A cache
+ * written in the same second as its source is valid, unlike with FileIsNewer().
+ */
+static bool IsCurrent(const char* cache_file, const char* source)
+{
+    struct stat st_cache;
+    struct stat st_source;
+    if (stat(cache_file, &st_cache) or stat(source, &st_source)) return false;
+
+    if (st_cache.st_mtim.tv_sec != st_source.st_mtim.tv_sec)
+        return st_cache.st_mtim.tv_sec > st_source.st_mtim.tv_sec;
+
+    return st_cache.st_mtim.tv_nsec >= st_source.st_mtim.tv_nsec;
+}
+
+/**
+ * @brief Maps the cache file. If source is given, the cache is used only if it was not modified
+ * before the source file. Files with arrays or strings outside of the file are rejected.
+ *
+ * @param cache_file cache file name
+ * @param source source file of the cached histogram
+ */
+HistCache::HistCache(const TString& cache_file, const char* source) : data(nullptr), size(0)
+{
+    memset(&hview, 0, sizeof(hview));
+
+    if (access(cache_file, R_OK)) return;
+    if (source and !IsCurrent(cache_file, source)) return;
+
+    int fd = open(cache_file, O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) or (size_t)st.st_size < sizeof(CacheHeader))
+    {
+        close(fd);
+        return;
+    }
+
+    void* mem = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+    {
+        perror(cache_file);
+        return;
+    }
+
+    const char* base = (const char*)mem;
+    const CacheHeader* hdr = (const CacheHeader*)base;
+    if (!IsValidCache(base, st.st_size))
+    {
+        Warning("HistCache", "Cache file %s is not valid", cache_file.Data());
+        munmap(mem, st.st_size);
+        return;
+    }
+
+    data = mem;
+    size = st.st_size;
+
+    hview.dim = hdr->dim;
+    for (int a = 0; a < 3; ++a)
+    {
+        hview.nbins[a] = hdr->nbins[a];
+        hview.variable[a] = hdr->variable[a];
+        hview.edges[a] = (const Double_t*)(base + hdr->edges_off[a]);
+    }
+    hview.contents = (const Double_t*)(base + hdr->contents_off);
+    hview.sumw2 = hdr->has_sumw2 ? (const Double_t*)(base + hdr->sumw2_off) : nullptr;
+    hview.entries = hdr->entries;
+    hview.name = base + hdr->name_off;
+    hview.title = base + hdr->title_off;
+}
+
+HistCache::~HistCache()
+{
+    if (data) munmap(data, size);
+}
+
+/**
+ * @brief Creates a histogram from the cache, owned by the caller and not attached to a directory.
+ *
+ * @return new histogram, nullptr if the cache is not valid
+ */
+TH1* HistCache::makeHistogram() const
+{
+    if (!data) return nullptr;
+
+    return MakeHistogram(hview);
+}
+
+TH1* RT::MakeHistogram(const HistView& v)
+{
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+
+    TH1* h = nullptr;
+    TArrayD* arr = nullptr;
+    if (v.dim == 1)
+    {
+        TH1D* h1 = v.variable[0] ? new TH1D(v.name, v.title, v.nbins[0], v.edges[0])
+                                 : new TH1D(v.name, v.title, v.nbins[0], v.edges[0][0],
+                                            v.edges[0][v.nbins[0]]);
+        h = h1;
+        arr = h1;
+    }
+    else if (v.dim == 2)
+    {
+        TH2D* h2 = (v.variable[0] or v.variable[1])
+                       ? new TH2D(v.name, v.title, v.nbins[0], v.edges[0], v.nbins[1], v.edges[1])
+                       : new TH2D(v.name, v.title, v.nbins[0], v.edges[0][0],
+                                  v.edges[0][v.nbins[0]], v.nbins[1], v.edges[1][0],
+                                  v.edges[1][v.nbins[1]]);
+        h = h2;
+        arr = h2;
+    }
+    else
+    {
+        TH3D* h3 = (v.variable[0] or v.variable[1] or v.variable[2])
+                       ? new TH3D(v.name, v.title, v.nbins[0], v.edges[0], v.nbins[1], v.edges[1],
+                                  v.nbins[2], v.edges[2])
+                       : new TH3D(v.name, v.title, v.nbins[0], v.edges[0][0],
+                                  v.edges[0][v.nbins[0]], v.nbins[1], v.edges[1][0],
+                                  v.edges[1][v.nbins[1]], v.nbins[2], v.edges[2][0],
+                                  v.edges[2][v.nbins[2]]);
+        h = h3;
+        arr = h3;
+    }
+
+    TH1::AddDirectory(add_dir);
+
+    Int_t ncells = v.GetNcells();
+    if (v.contents) memcpy(arr->GetArray(), v.contents, ncells * sizeof(Double_t));
+
+    if (v.sumw2)
+    {
+        h->Sumw2();
+        memcpy(h->GetSumw2()->GetArray(), v.sumw2, ncells * sizeof(Double_t));
+    }
+
+    h->SetEntries(v.entries);
+
+    return h;
+}
+
+/**
+ * @brief Writes the histogram into the cache file. The file is written under a temporary name
+ * and renamed, so a concurrent reader never maps a partial file.
+ *
+ * @param h histogram, any TH1, TH2 or TH3; contents are stored as double
+ * @param cache_file cache file name
+ * @return true on success
+ */
+Bool_t HistCache::write(const TH1* h, const TString& cache_file)
+{
+    const TAxis* axes[3] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+
+    CacheHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, cache_magic, sizeof(cache_magic));
+
+    hdr.dim = h->GetDimension();
+    hdr.entries = h->GetEntries();
+    hdr.has_sumw2 = h->GetSumw2N() > 0;
+
+    size_t name_len = strlen(h->GetName()) + 1;
+    size_t title_len = strlen(h->GetTitle()) + 1;
+
+    ULong64_t off = Align8(sizeof(CacheHeader));
+    hdr.name_off = off;
+    off = Align8(off + name_len);
+    hdr.title_off = off;
+    off = Align8(off + title_len);
+
+    std::vector<Double_t> edges[3];
+    for (int a = 0; a < 3; ++a)
+    {
+        Int_t n = axes[a]->GetNbins();
+        hdr.nbins[a] = n;
+        hdr.variable[a] = axes[a]->IsVariableBinSize();
+
+        for (Int_t i = 1; i <= n; ++i)
+            edges[a].push_back(axes[a]->GetBinLowEdge(i));
+        edges[a].push_back(axes[a]->GetBinUpEdge(n));
+
+        hdr.edges_off[a] = off;
+        off += edges[a].size() * sizeof(Double_t);
+    }
+
+    Int_t ncells = h->GetNcells();
+    std::vector<Double_t> contents(ncells);
+    for (Int_t bin = 0; bin < ncells; ++bin)
+        contents[bin] = h->GetBinContent(bin);
+
+    hdr.contents_off = off;
+    off += ncells * sizeof(Double_t);
+
+    if (hdr.has_sumw2)
+    {
+        hdr.sumw2_off = off;
+        off += ncells * sizeof(Double_t);
+    }
+
+    hdr.total_size = off;
+
+    TString tmp_file = cache_file + ".tmp";
+    std::ofstream ofs(tmp_file.Data(), std::ios::binary | std::ios::trunc);
+    if (!ofs)
+    {
+        Error("HistCache", "Can't write cache file %s", tmp_file.Data());
+        return kFALSE;
+    }
+
+    const char zeros[8] = {0};
+    auto pad_to = [&](ULong64_t pos) { ofs.write(zeros, pos - (ULong64_t)ofs.tellp()); };
+
+    ofs.write((const char*)&hdr, sizeof(hdr));
+    pad_to(hdr.name_off);
+    ofs.write(h->GetName(), name_len);
+    pad_to(hdr.title_off);
+    ofs.write(h->GetTitle(), title_len);
+    pad_to(hdr.edges_off[0]);
+    for (int a = 0; a < 3; ++a)
+        ofs.write((const char*)edges[a].data(), edges[a].size() * sizeof(Double_t));
+    ofs.write((const char*)contents.data(), ncells * sizeof(Double_t));
+    if (hdr.has_sumw2)
+        ofs.write((const char*)h->GetSumw2()->GetArray(), ncells * sizeof(Double_t));
+
+    ofs.close();
+    if (!ofs or rename(tmp_file, cache_file))
+    {
+        Error("HistCache", "Can't write cache file %s", cache_file.Data());
+        unlink(tmp_file);
+        return kFALSE;
+    }
+
+    return kTRUE;
+}
+
+/**
+ * @brief Loads the histogram from the cache if it is newer than the file, otherwise reads it
+ * from the file and refreshes the cache.
+ *
+ * @param f source file
+ * @param name histogram name in the file
+ * @param cache_file cache file name
+ * @return histogram owned by the caller, nullptr if not found
+ */
+TH1* HistCache::fetch(TFile* f, const TString& name, const TString& cache_file)
+{
+    // a cache holding another histogram is replaced
+    Ssiz_t slash = name.Last('/');
+    TString hname = slash == kNPOS ? name : TString(name(slash + 1, name.Length()));
+    {
+        HistCache cache(cache_file, f->GetName());
+        if (cache.isValid() and hname == cache.view().name) return cache.makeHistogram();
+    }
+
+    TH1* h = dynamic_cast<TH1*>(f->Get(name));
+    if (!h)
+    {
+        Error("HistCache", "Can't find %s in file %s", name.Data(), f->GetName());
+        return nullptr;
+    }
+
+    h->SetDirectory(nullptr);
+    write(h, cache_file);
+
+    return h;
+}
@@ -0,0 +1,210 @@
+#include "HistMerger.h"
+
+#include "FileAccessor.h"
+#include "Parallel.h"
+
+#include <TClass.h>
+#include <TDirectory.h>
+#include <TError.h>
+#include <TFile.h>
+#include <TH1.h>
+
+using namespace RT;
+
+/**
+ * @param workers number of threads, 0 for one per CPU
+ * @param budget memory budget in bytes, estimated from the uncompressed size of the keys
+ */
+HistMerger::HistMerger(UInt_t workers, size_t budget)
+    : workers(GetWorkers(workers)), budget(budget), cnt_missing(0), cnt_failed(0)
+{
+    EnableThreadSafety();
+}
+
+void HistMerger::add(const TString& filename) { inputs.push_back(filename); }
+
+void HistMerger::add(const std::vector<TString>& filenames)
+{
+    inputs.insert(inputs.end(), filenames.begin(), filenames.end());
+}
+
+/**
+ * @brief Sums the histograms of the inputs [first, last) into the partial result.
+ *
+ * The accessors of the inputs are opened on the first chunk and kept for the next ones, so each
+ * input is opened and indexed once per merge(); their cached objects are dropped after each chunk.
+ */
+void HistMerger::mergeRange(const std::vector<TString>& names, size_t first, size_t last,
+                            std::vector<FileAccessor*>& accessors, Partial& partial)
+{
+    partial.objects.assign(names.size(), nullptr);
+    partial.missing = 0;
+    partial.failed = 0;
+
+    std::vector<TObject*> objs;
+    for (size_t f = first; f < last; ++f)
+    {
+        if (!accessors[f]) accessors[f] = new FileAccessor(inputs[f], budget);
+
+        FileAccessor& acc = *accessors[f];
+        if (!acc.isOpen())
+        {
+            partial.missing += names.size();
+            continue;
+        }
+
+        partial.missing += acc.get(names, objs);
+
+        for (size_t k = 0; k < names.size(); ++k)
+        {
+            TH1* h = dynamic_cast<TH1*>(objs[k]);
+            if (!h) continue;
+
+            if (!partial.objects[k])
+                partial.objects[k] = h->Clone();
+            else if (!((TH1*)partial.objects[k])->Add(h))
+                ++partial.failed;
+        }
+
+        acc.clear();
+    }
+}
+
+/**
+ * @brief Pairwise reduction of the partial results, the sum ends in the first one.
+ */
+void HistMerger::reduce(std::vector<Partial>& partials)
+{
+    for (size_t stride = 1; stride < partials.size(); stride *= 2)
+    {
+        size_t pairs = (partials.size() - stride + 2 * stride - 1) / (2 * stride);
+
+        ParallelFor(pairs, workers, [&](size_t p) {
+            Partial& dst = partials[2 * stride * p];
+            Partial& src = partials[2 * stride * p + stride];
+
+            for (size_t k = 0; k < dst.objects.size(); ++k)
+            {
+                TObject* b = src.objects[k];
+                if (!b) continue;
+
+                if (!dst.objects[k])
+                    dst.objects[k] = b;
+                else
+                {
+                    if (!((TH1*)dst.objects[k])->Add((TH1*)b)) ++dst.failed;
+                    delete b;
+                }
+                src.objects[k] = nullptr;
+            }
+
+            dst.missing += src.missing;
+            dst.failed += src.failed;
+        });
+    }
+}
+
+/**
+ * @brief Merges all inputs into the output file.
+ *
+ * @param output output file name, recreated
+ * @return number of written histograms, -1 if the first input or the output can't be opened
+ */
+Int_t HistMerger::merge(const TString& output)
+{
+    cnt_missing = 0;
+    cnt_failed = 0;
+
+    if (inputs.empty()) return -1;
+
+    std::vector<FileAccessor::KeyInfo> keys;
+    {
+        FileAccessor first(inputs[0], 0);
+        if (!first.isOpen()) return -1;
+
+        for (const auto& k : first.getIndex())
+        {
+            TClass* cl = TClass::GetClass(k.class_name);
+            if (cl and cl->InheritsFrom(TH1::Class())) keys.push_back(k);
+        }
+    }
+
+    TFile* out = TFile::Open(output, "RECREATE");
+    if (!out or out->IsZombie())
+    {
+        Error("HistMerger", "Can't open output file %s", output.Data());
+        delete out;
+        return -1;
+    }
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+
+    size_t nparts = workers < inputs.size() ? workers : inputs.size();
+
+    // every thread holds its partial sums and the objects of one input
+    size_t chunk_budget = budget / (2 * nparts);
+
+    // inputs of each thread stay open for all chunks
+    std::vector<FileAccessor*> accessors(inputs.size(), nullptr);
+
+    Int_t written = 0;
+    size_t next = 0;
+    while (next < keys.size())
+    {
+        std::vector<TString> names;
+        size_t chunk_size = 0;
+        for (; next < keys.size(); ++next)
+        {
+            if (!names.empty() and chunk_size + keys[next].size > chunk_budget) break;
+
+            names.push_back(keys[next].name);
+            chunk_size += keys[next].size;
+        }
+
+        std::vector<Partial> partials(nparts);
+        ParallelFor(nparts, nparts, [&](size_t p) {
+            mergeRange(names, p * inputs.size() / nparts, (p + 1) * inputs.size() / nparts,
+                       accessors, partials[p]);
+        });
+
+        reduce(partials);
+
+        cnt_missing += partials[0].missing;
+        cnt_failed += partials[0].failed;
+
+        for (size_t k = 0; k < names.size(); ++k)
+        {
+            TObject* obj = partials[0].objects[k];
+            if (!obj) continue;
+
+            TDirectory* dir = out;
+            TString name = names[k];
+            Ssiz_t slash = name.Last('/');
+            if (slash != kNPOS)
+            {
+                TString path = name(0, slash);
+                dir = out->mkdir(path, "", kTRUE);
+                name = name(slash + 1, name.Length() - slash - 1);
+            }
+
+            dir->WriteTObject(obj, name);
+            ++written;
+
+            delete obj;
+        }
+    }
+
+    for (FileAccessor* acc : accessors)
+        delete acc;
+
+    TH1::AddDirectory(add_dir);
+
+    if (cnt_missing) Warning("HistMerger", "%zu objects were missing in the inputs", cnt_missing);
+    if (cnt_failed) Error("HistMerger", "%zu histograms could not be added", cnt_failed);
+
+    out->Close();
+    delete out;
+
+    return written;
+}
@@ -0,0 +1,126 @@
+#include "HistPyramid.h"
+
+#include <TVirtualPad.h>
+
+using namespace RT;
+
+/**
+ * @brief Coarser axis edges, two neighbouring bins are merged; the last bin of an odd axis stays.
+ */
+static std::vector<Double_t> MergeEdges(const TAxis* axis)
+{
+    Int_t nbins = axis->GetNbins();
+
+    std::vector<Double_t> edges;
+    for (Int_t i = 1; i <= nbins; i += 2)
+        edges.push_back(axis->GetBinLowEdge(i));
+    edges.push_back(axis->GetBinUpEdge(nbins));
+
+    return edges;
+}
+
+/**
+ * @brief Index of the merged bin, underflow and overflow are kept.
+ */
+static inline Int_t MergedBin(Int_t bin, Int_t nbins, Int_t new_nbins)
+{
+    if (bin == 0) return 0;
+    if (bin > nbins) return new_nbins + 1;
+    return (bin + 1) / 2;
+}
+
+/**
+ * @brief Builds the pyramid, levels are added until both axes have at most min_bins bins.
+ *
+ * @param h source histogram, level 0
+ * @param min_bins bins limit for the coarsest level
+ */
+HistPyramid::HistPyramid(TH2* h, Int_t min_bins)
+{
+    if (min_bins < 1) min_bins = 1;
+
+    levels.push_back(h);
+
+    TH2* prev = h;
+    while (prev->GetNbinsX() > min_bins or prev->GetNbinsY() > min_bins)
+    {
+        prev = makeLevel(prev, levels.size());
+        levels.push_back(prev);
+    }
+}
+
+HistPyramid::~HistPyramid()
+{
+    for (size_t i = 1; i < levels.size(); ++i)
+        delete levels[i];
+}
+
+TH2* HistPyramid::selectLevel(UInt_t px_x, UInt_t px_y) const
+{
+    for (size_t l = levels.size(); l-- > 0;)
+    {
+        if ((UInt_t)levels[l]->GetNbinsX() >= px_x and (UInt_t)levels[l]->GetNbinsY() >= px_y)
+            return levels[l];
+    }
+
+    return levels[0];
+}
+
+/**
+ * @brief Selects level matching the pixel size of the pad frame.
+ */
+TH2* HistPyramid::selectLevel(TVirtualPad* pad) const
+{
+    Double_t w = pad->GetWw() * pad->GetAbsWNDC();
+    Double_t h = pad->GetWh() * pad->GetAbsHNDC();
+
+    UInt_t px_x = w * (1.0 - pad->GetLeftMargin() - pad->GetRightMargin());
+    UInt_t px_y = h * (1.0 - pad->GetTopMargin() - pad->GetBottomMargin());
+
+    return selectLevel(px_x, px_y);
+}
+
+TH2D* HistPyramid::makeLevel(const TH2* prev, Int_t level) const
+{
+    const TAxis* xaxis = prev->GetXaxis();
+    const TAxis* yaxis = prev->GetYaxis();
+
+    std::vector<Double_t> xedges = MergeEdges(xaxis);
+    std::vector<Double_t> yedges = MergeEdges(yaxis);
+
+    Int_t nx = xaxis->GetNbins();
+    Int_t ny = yaxis->GetNbins();
+    Int_t new_nx = xedges.size() - 1;
+    Int_t new_ny = yedges.size() - 1;
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+    TH2D* h = new TH2D(TString::Format("%s_lvl%d", levels[0]->GetName(), level),
+                       levels[0]->GetTitle(), new_nx, xedges.data(), new_ny, yedges.data());
+    TH1::AddDirectory(add_dir);
+
+    h->Sumw2();
+
+    Double_t* cont = h->GetArray();
+    Double_t* sumw2 = h->GetSumw2()->GetArray();
+
+    const TArrayD* prev_sumw2 = prev->GetSumw2N() ? prev->GetSumw2() : nullptr;
+
+    for (Int_t y = 0; y <= ny + 1; ++y)
+    {
+        Int_t row = (new_nx + 2) * MergedBin(y, ny, new_ny);
+        for (Int_t x = 0; x <= nx + 1; ++x)
+        {
+            Int_t bin = prev->GetBin(x, y);
+            Int_t new_bin = row + MergedBin(x, nx, new_nx);
+
+            Double_t bc = prev->GetBinContent(bin);
+            cont[new_bin] += bc;
+            sumw2[new_bin] += prev_sumw2 ? prev_sumw2->At(bin) : fabs(bc);
+        }
+    }
+
+    h->SetEntries(prev->GetEntries());
+
+    return h;
+}
@@ -0,0 +1,100 @@
+#include "IntegralCache.h"
+#include "RootTools.h"
+
+#include <TF1.h>
+
+using namespace RT;
+
+// 5-point Gauss-Legendre nodes and weights on [-1, 1]
+static const Double_t gl_nodes[5] = {-0.9061798459386640, -0.5384693101056831, 0.0,
+                                     0.5384693101056831, 0.9061798459386640};
+static const Double_t gl_weights[5] = {0.2369268850561891, 0.4786286704993665,
+                                       0.5688888888888889, 0.4786286704993665,
+                                       0.2369268850561891};
+
+/**
+ * @param f function, must live as long as the cache
+ * @param npoints number of intervals of the table
+ */
+IntegralCache::IntegralCache(TF1* f, Int_t npoints)
+    : func(f), npoints(npoints > 0 ? npoints : 1), builds(0), xmin(0), xmax(0)
+{
+}
+
+Bool_t IntegralCache::isValid() const
+{
+    if (cdf.empty()) return kFALSE;
+    if (func->GetXmin() != xmin or func->GetXmax() != xmax) return kFALSE;
+
+    const Double_t* par = func->GetParameters();
+    for (size_t i = 0; i < params.size(); ++i)
+        if (par[i] != params[i]) return kFALSE;
+
+    return kTRUE;
+}
+
+void IntegralCache::build()
+{
+    xmin = func->GetXmin();
+    xmax = func->GetXmax();
+
+    Int_t npar = func->GetNpar();
+    const Double_t* par = func->GetParameters();
+    params.assign(par, par + npar);
+
+    cdf.resize(npoints + 1);
+    values.resize(npoints + 1);
+
+    Double_t h = (xmax - xmin) / npoints;
+    cdf[0] = 0.0;
+    values[0] = func->Eval(xmin);
+    for (Int_t i = 0; i < npoints; ++i)
+    {
+        Double_t mid = xmin + (i + 0.5) * h;
+        Double_t sum = 0.0;
+        for (int k = 0; k < 5; ++k)
+            sum += gl_weights[k] * func->Eval(mid + 0.5 * h * gl_nodes[k]);
+
+        cdf[i + 1] = cdf[i] + 0.5 * h * sum;
+        values[i + 1] = func->Eval(xmin + (i + 1) * h);
+    }
+
+    ++builds;
+}
+
+Double_t IntegralCache::cumulative(Double_t x) const
+{
+    Double_t h = (xmax - xmin) / npoints;
+    Double_t pos = (x - xmin) / h;
+    Int_t i = (Int_t)pos;
+    if (i >= npoints) return cdf[npoints];
+    if (i < 0) return 0.0;
+
+    Double_t t = pos - i;
+    Double_t t2 = t * t;
+    Double_t t3 = t2 * t;
+
+    return (2 * t3 - 3 * t2 + 1) * cdf[i] + (t3 - 2 * t2 + t) * h * values[i] +
+           (-2 * t3 + 3 * t2) * cdf[i + 1] + (t3 - t2) * h * values[i + 1];
+}
+
+/**
+ * @brief Integral of the function from l to u, rebuilds the table if the function has changed.
+ */
+Double_t IntegralCache::integral(Double_t l, Double_t u)
+{
+    if (l < func->GetXmin() or u > func->GetXmax() or l > u) return func->Integral(l, u);
+
+    if (!isValid()) build();
+
+    return cumulative(u) - cumulative(l);
+}
+
+/**
+ * @brief Same as calcSubstractionError() of TF1, with cached integrals.
+ */
+std::pair<double, double> RT::calcSubstractionError(IntegralCache& total, IntegralCache& bkg,
+                                                    double l, double u, bool verbose)
+{
+    return calcSubstractionError(total.integral(l, u), bkg.integral(l, u), verbose);
+}
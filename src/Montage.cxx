@@ -0,0 +1,194 @@
+#include "Montage.h"
+
+#include "Parallel.h"
+
+#include <TASImage.h>
+#include <TCanvas.h>
+#include <TError.h>
+#include <TROOT.h>
+
+#include <cstdio>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct MontageLayout
+{
+    UInt_t columns;
+    UInt_t rows;
+    UInt_t tile_width;
+    UInt_t tile_height;
+    UInt_t width;
+    UInt_t height;
+};
+
+static Bool_t MakeLayout(size_t tiles, UInt_t columns, UInt_t width, UInt_t height,
+                         MontageLayout& layout)
+{
+    if (!tiles or !columns) return kFALSE;
+
+    layout.columns = columns;
+    layout.rows = (tiles + columns - 1) / columns;
+    layout.tile_width = width / layout.columns;
+    layout.tile_height = height / layout.rows;
+    layout.width = width;
+    layout.height = height;
+
+    return layout.tile_width > 0 and layout.tile_height > 0;
+}
+
+static Bool_t CopyTile(TASImage& img, const MontageLayout& layout, size_t idx, UInt_t* atlas)
+{
+    if (!img.IsValid()) return kFALSE;
+
+    if (img.GetWidth() != layout.tile_width or img.GetHeight() != layout.tile_height)
+        img.Scale(layout.tile_width, layout.tile_height);
+
+    UInt_t* argb = img.GetArgbArray();
+    if (!argb) return kFALSE;
+
+    UInt_t ox = (idx % layout.columns) * layout.tile_width;
+    UInt_t oy = (idx / layout.columns) * layout.tile_height;
+
+    for (UInt_t y = 0; y < layout.tile_height; ++y)
+        memcpy(&atlas[(oy + y) * layout.width + ox], &argb[y * layout.tile_width],
+               layout.tile_width * sizeof(UInt_t));
+
+    return kTRUE;
+}
+
+static Bool_t RenderTile(TCanvas* can, const MontageLayout& layout, size_t idx, UInt_t* atlas)
+{
+    UInt_t ww = can->GetWw();
+    UInt_t wh = can->GetWh();
+
+    can->SetCanvasSize(layout.tile_width, layout.tile_height);
+
+    TASImage img;
+    img.FromPad(can);
+
+    can->SetCanvasSize(ww, wh);
+
+    return CopyTile(img, layout, idx, atlas);
+}
+
+static Bool_t WriteAtlas(const UInt_t* atlas, const MontageLayout& layout, const TString& filename)
+{
+    TASImage img(layout.width, layout.height);
+    UInt_t* argb = img.GetArgbArray();
+    if (!argb) return kFALSE;
+
+    memcpy(argb, atlas, layout.width * layout.height * sizeof(UInt_t));
+    img.WriteImage(filename);
+
+    return kTRUE;
+}
+
+Int_t RT::Exports::ExportMontage(const std::vector<TCanvas*>& canvases, const TString& filename,
+                                 UInt_t columns, UInt_t width, UInt_t height, UInt_t workers)
+{
+    MontageLayout layout;
+    if (!MakeLayout(canvases.size(), columns, width, height, layout)) return -1;
+
+    workers = GetWorkers(workers);
+    if (workers > canvases.size()) workers = canvases.size();
+
+    // shared with the workers, they write their tiles directly into the atlas
+    size_t bytes = (size_t)layout.width * layout.height * sizeof(UInt_t);
+    void* mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        perror("mmap");
+        return -1;
+    }
+
+    UInt_t* atlas = (UInt_t*)mem;
+    for (size_t i = 0; i < (size_t)layout.width * layout.height; ++i)
+        atlas[i] = 0xffffffff;
+
+    Int_t failed = 0;
+
+    if (workers == 1)
+    {
+        for (size_t i = 0; i < canvases.size(); ++i)
+            if (!RenderTile(canvases[i], layout, i, atlas)) ++failed;
+    }
+    else
+    {
+        fflush(stdout);
+        fflush(stderr);
+
+        std::vector<pid_t> pids;
+        for (UInt_t w = 0; w < workers; ++w)
+        {
+            pid_t pid = fork();
+            if (pid < 0)
+            {
+                perror("fork");
+                break;
+            }
+
+            if (pid == 0)
+            {
+                gROOT->SetBatch(kTRUE);
+
+                Int_t worker_failed = 0;
+                for (size_t i = w; i < canvases.size(); i += workers)
+                    if (!RenderTile(canvases[i], layout, i, atlas)) ++worker_failed;
+
+                _exit(worker_failed < 255 ? worker_failed : 255);
+            }
+
+            pids.push_back(pid);
+        }
+
+        for (UInt_t w = 0; w < workers; ++w)
+        {
+            Int_t worker_tiles = (canvases.size() - w + workers - 1) / workers;
+            if (w >= pids.size())
+            {
+                failed += worker_tiles;
+                continue;
+            }
+
+            int status = 0;
+            waitpid(pids[w], &status, 0);
+            if (WIFEXITED(status))
+                failed += WEXITSTATUS(status);
+            else
+                failed += worker_tiles;
+        }
+    }
+
+    if (failed)
+        Error("ExportMontage", "%d tiles of %s could not be rendered", failed, filename.Data());
+
+    Bool_t written = WriteAtlas(atlas, layout, filename);
+    munmap(mem, bytes);
+
+    return written ? failed : -1;
+}
+
+Int_t RT::Exports::ExportMontage(const std::vector<TASImage*>& images, const TString& filename,
+                                 UInt_t columns, UInt_t width, UInt_t height)
+{
+    MontageLayout layout;
+    if (!MakeLayout(images.size(), columns, width, height, layout)) return -1;
+
+    std::vector<UInt_t> atlas((size_t)layout.width * layout.height, 0xffffffff);
+
+    Int_t failed = 0;
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        TASImage* tile = images[i] ? (TASImage*)images[i]->Clone("") : nullptr;
+        if (!tile or !CopyTile(*tile, layout, i, atlas.data())) ++failed;
+        delete tile;
+    }
+
+    if (failed)
+        Error("ExportMontage", "%d tiles of %s could not be used", failed, filename.Data());
+
+    return WriteAtlas(atlas.data(), layout, filename) ? failed : -1;
+}
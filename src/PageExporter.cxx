@@ -0,0 +1,83 @@
+#include "PageExporter.h"
+
+#include <TCanvas.h>
+#include <TError.h>
+
+#include <fstream>
+
+using namespace RT::Exports;
+
+PageExporter* PageExporter::current = nullptr;
+
+PageExporter::PageExporter(const TString& filename) : filename(filename), canvas(nullptr)
+{
+    if (current)
+    {
+        Error("PageExporter", "Cannot open %s while %s is open", filename.Data(),
+              current->filename.Data());
+        return;
+    }
+    current = this;
+
+    Int_t oldLevel = gErrorIgnoreLevel;
+    gErrorIgnoreLevel = kWarning;
+    canvas = new TCanvas(TString::Format("rt_page_exporter_%p", (void*)this), "", 100, 100);
+    canvas->Print(filename + "[");
+    gErrorIgnoreLevel = oldLevel;
+}
+
+PageExporter::~PageExporter() { close(); }
+
+/**
+ * @brief Appends the canvas as a new page.
+ *
+ * @param can canvas to print
+ * @param title page title used for the outline and index, canvas title if empty
+ */
+void PageExporter::addPage(TCanvas* can, const TString& title)
+{
+    if (!canvas) return;
+
+    Page page;
+    page.name = can->GetName();
+    page.title = title.IsNull() ? TString(can->GetTitle()) : title;
+
+    Int_t oldLevel = gErrorIgnoreLevel;
+    gErrorIgnoreLevel = kWarning;
+    can->Print(filename, TString::Format("Title:%s", page.title.Data()));
+    gErrorIgnoreLevel = oldLevel;
+
+    pages.push_back(page);
+}
+
+void PageExporter::close()
+{
+    if (!canvas) return;
+
+    Int_t oldLevel = gErrorIgnoreLevel;
+    gErrorIgnoreLevel = kWarning;
+    canvas->Print(filename + "]");
+    gErrorIgnoreLevel = oldLevel;
+
+    delete canvas;
+    canvas = nullptr;
+    current = nullptr;
+}
+
+/**
+ * @brief Writes the table of contents, one line per page: number, canvas name and title.
+ *
+ * @param filename index file name
+ * @return true on success
+ */
+Bool_t PageExporter::writeIndex(const TString& filename) const
+{
+    std::ofstream ofs(filename.Data());
+    if (!ofs.is_open()) return kFALSE;
+
+    ofs << "# " << this->filename.Data() << "\n";
+    for (size_t i = 0; i < pages.size(); ++i)
+        ofs << i + 1 << "\t" << pages[i].name.Data() << "\t" << pages[i].title.Data() << "\n";
+
+    return kTRUE;
+}
@@ -0,0 +1,60 @@
+#include "Parallel.h"
+
+#include <RVersion.h>
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 8, 0)
+#include <TROOT.h>
+#else
+#include <TThread.h>
+#endif
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+UInt_t RT::GetWorkers(UInt_t workers)
+{
+    if (workers) return workers;
+
+    long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return ncpus > 0 ? ncpus : 1;
+}
+
+void RT::EnableThreadSafety()
+{
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 8, 0)
+    ROOT::EnableThreadSafety();
+#else
+    TThread::Initialize();
+#endif
+}
+
+void RT::ParallelFor(size_t n, UInt_t workers, const std::function<void(size_t)>& fn)
+{
+    workers = GetWorkers(workers);
+    if (workers > n) workers = n;
+
+    if (workers <= 1)
+    {
+        for (size_t i = 0; i < n; ++i)
+            fn(i);
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto loop = [&]() {
+        size_t i;
+        while ((i = next++) < n)
+            fn(i);
+    };
+
+    std::vector<std::thread> threads;
+    for (UInt_t w = 1; w < workers; ++w)
+        threads.emplace_back(loop);
+
+    loop();
+
+    for (auto& t : threads)
+        t.join();
+}
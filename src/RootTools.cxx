@@ -1,6 +1,20 @@
 #include "RootTools.h"
-
+#include "GraphDecimation.h"
+#include "HistCache.h"
+#include "HistPyramid.h"
+#include "SparseBins.h"
+#include "Tokenizer.h"
+
+#include <Foption.h>
+#include <HFitInterface.h>
+#include <Math/Factory.h>
+#include <Math/Functor.h>
+#include <Math/IntegratorOneDim.h>
+#include <Math/Minimizer.h>
+#include <Math/MinimizerOptions.h>
+#include <RVersion.h>
 #include <TASImage.h>
+#include <TBufferFile.h>
 #include <TCanvas.h>
 #include <TColor.h>
 #include <TError.h>
@@ -8,18 +22,29 @@
 #include <TFile.h>
 #include <TGraph.h>
 #include <TLatex.h>
+#include <TList.h>
 #include <TMath.h>
 #include <TObjString.h>
+#include <TPRegexp.h>
 #include <TPaletteAxis.h>
 #include <TROOT.h>
 #include <TStyle.h>
 #include <TSystem.h>
 #include <TVirtualPad.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <string>
 
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+#if !defined(__cpp_lib_to_chars)
+#include <locale.h>
+#endif
+
 #include <sys/stat.h>
 
 #define PR(x)                                                                                      \
@@ -243,7 +268,6 @@ void ExportEPS(TCanvas* can, const TString& path)
     Int_t oldLevel = gErrorIgnoreLevel;
     gErrorIgnoreLevel = kWarning;
     TString filename = path + TString::Format("%s.eps", can->GetName());
-    can->Draw();
     can->Print(filename);
     gErrorIgnoreLevel = oldLevel;
 }
@@ -286,6 +310,25 @@ void SaveAndClose(TCanvas* can, TFile* f, Bool_t export_images, const TString& p
     can->Close();
 }
 
+auto SerializeCanvas(TCanvas* can) -> std::vector<char>
+{
+    TBufferFile buf(TBuffer::kWrite);
+    buf.WriteObject(can);
+
+    return std::vector<char>(buf.Buffer(), buf.Buffer() + buf.Length());
+}
+
+TCanvas* DeserializeCanvas(const char* data, size_t size)
+{
+    TBufferFile buf(TBuffer::kRead, size, const_cast<char*>(data), kFALSE);
+    TCanvas* can = (TCanvas*)buf.ReadObject(TCanvas::Class());
+    if (!can) return nullptr;
+
+    // streamed canvas is not built, drawing creates its graphics context
+    can->Draw();
+    return can;
+}
+
 } // namespace RT::Exports
 
 // Theta in ptvsRap, von der Chii
@@ -401,33 +444,176 @@ void DrawLine(Double_t x1, Double_t y1, Double_t x2, Double_t y2, Int_t color, I
 
 };
 
+namespace RT::Palettes
+{
+
+struct PaletteDef
+{
+    std::vector<Double_t> stops;
+    std::vector<Double_t> red;
+    std::vector<Double_t> green;
+    std::vector<Double_t> blue;
+    UInt_t ncont;
+    Float_t alpha;
+
+    std::vector<Int_t> colors;
+};
+
+static std::vector<PaletteDef>& registry()
+{
+    static std::vector<PaletteDef> palettes;
+    return palettes;
+}
+
+Int_t Create(UInt_t nstops, const Double_t* stops, const Double_t* red, const Double_t* green,
+             const Double_t* blue, UInt_t ncont, Float_t alpha)
+{
+    PaletteDef def;
+    def.stops.assign(stops, stops + nstops);
+    def.red.assign(red, red + nstops);
+    def.green.assign(green, green + nstops);
+    def.blue.assign(blue, blue + nstops);
+    def.ncont = ncont;
+    def.alpha = alpha;
+
+    std::vector<PaletteDef>& palettes = registry();
+    for (size_t i = 0; i < palettes.size(); ++i)
+    {
+        const PaletteDef& p = palettes[i];
+        if (p.ncont == def.ncont and p.alpha == def.alpha and p.stops == def.stops and
+            p.red == def.red and p.green == def.green and p.blue == def.blue)
+        {
+            Use(i);
+            return i;
+        }
+    }
+
+    Int_t first = TColor::CreateGradientColorTable(nstops, def.stops.data(), def.red.data(),
+                                                   def.green.data(), def.blue.data(), ncont, alpha);
+    if (first < 0) return -1;
+
+    def.colors.resize(ncont);
+    for (UInt_t i = 0; i < ncont; ++i)
+        def.colors[i] = first + i;
+
+    palettes.push_back(def);
+
+    Int_t id = palettes.size() - 1;
+    Use(id);
+    return id;
+}
+
+Bool_t Use(Int_t id)
+{
+    std::vector<PaletteDef>& palettes = registry();
+    if (id < 0 or id >= (Int_t)palettes.size()) return kFALSE;
+
+    PaletteDef& p = palettes[id];
+    gStyle->SetPalette(p.ncont, p.colors.data(), p.alpha);
+    gStyle->SetNumberContours(p.ncont);
+    return kTRUE;
+}
+
+Int_t GetNColors(Int_t id)
+{
+    std::vector<PaletteDef>& palettes = registry();
+    if (id < 0 or id >= (Int_t)palettes.size()) return 0;
+
+    return palettes[id].colors.size();
+}
+
+const Int_t* GetColors(Int_t id)
+{
+    std::vector<PaletteDef>& palettes = registry();
+    if (id < 0 or id >= (Int_t)palettes.size()) return nullptr;
+
+    return palettes[id].colors.data();
+}
+
+} // namespace RT::Palettes
+
+/**
+ * @brief Removes the palette request (the 'z' flag) from a draw option, e.g. "colz" -> "col".
+ * Only the flag is removed, other options containing the letter are kept.
+ */
+static TString StripPaletteOption(const TString& option)
+{
+    TString opt = option;
+    // the flag after an option which draws a palette, e.g. "colz", "cont4z", "surf1z same"
+    TPRegexp("(col|cont[0-9]?|surf[0-9]?|lego[0-9]?)z").Substitute(opt, "$1", "gi");
+    // and the standalone flag, e.g. "col z"
+    TPRegexp("(^|[^a-z])z(?![a-z])").Substitute(opt, "$1", "gi");
+    return opt;
+}
+
+/**
+ * @brief Configures the palette axis of the histogram. If the palette does not exist yet, it is
+ * created and attached to the histogram in NDC coordinates next to the pad frame, so the pad does
+ * not need to be painted first. The label and title attributes are taken by the palette from the Z
+ * axis, zero values are left untouched.
+ *
+ * @param h histogram
+ * @param ls label size
+ * @param ts title size
+ * @param to title offset
+ * @return palette axis
+ */
 TPaletteAxis* RT::NicePalette(TH2* h, Float_t ls, Float_t ts, Float_t to)
 {
-    (void)ls;
-    (void)ts;
-    (void)to;
-    gPad->Update();
+    TAxis* zaxis = h->GetZaxis();
+    if (ls > 0) zaxis->SetLabelSize(ls);
+    if (ts > 0) zaxis->SetTitleSize(ts);
+    if (to > 0) zaxis->SetTitleOffset(to);
 
     TPaletteAxis* axis = (TPaletteAxis*)h->GetListOfFunctions()->FindObject("palette");
+    if (axis) return axis;
+
+    Float_t mT = gPad ? gPad->GetTopMargin() : 0.1;
+    Float_t mR = gPad ? gPad->GetRightMargin() : gStyle->GetPadRightMargin();
+    Float_t mB = gPad ? gPad->GetBottomMargin() : 0.1;
 
-    if (!axis) return nullptr;
+    axis = new TPaletteAxis(0, 0, 0, 0, h);
+    axis->SetName("palette");
+    axis->SetX1NDC(1.0 - mR + 0.005);
+    axis->SetX2NDC(1.0 - mR + 0.05);
+    axis->SetY1NDC(mB);
+    axis->SetY2NDC(1.0 - mT);
+    h->GetListOfFunctions()->Add(axis);
 
     return axis;
 }
 
+/**
+ * @brief Removes the palette axis from the histogram. The 'z' flag is removed from the histogram
+ * draw options (also in the current pad), so the palette is not recreated on the next paint.
+ *
+ * @param h histogram
+ * @return always nullptr
+ */
 TPaletteAxis* RT::NoPalette(TH2* h)
 {
-    gPad->Update();
-
     TPaletteAxis* axis = (TPaletteAxis*)h->GetListOfFunctions()->FindObject("palette");
+    if (axis)
+    {
+        h->GetListOfFunctions()->Remove(axis);
+        delete axis;
+    }
 
-    if (!axis) return nullptr;
+    h->SetOption(StripPaletteOption(h->GetOption()));
 
-    (TPaletteAxis*)h->GetListOfFunctions()->Remove(axis);
-    axis->Delete();
-    return 0;
-}
+    if (gPad)
+    {
+        TObjLink* lnk = gPad->GetListOfPrimitives()->FirstLink();
+        while (lnk)
+        {
+            if (lnk->GetObject() == h) lnk->SetOption(StripPaletteOption(lnk->GetOption()));
+            lnk = lnk->Next();
+        }
+        gPad->Modified();
+    }
 
+    return nullptr;
+}
 
 void RT::AutoScale(TH1* hdraw, TH1* href, Bool_t MinOnZero)
 {
@@ -519,11 +705,11 @@ void RT::AutoScaleF(TH1* hdraw, TH1* href)
     hdraw->GetYaxis()->SetRangeUser(scalemin, scalemax);
 }
 
-std::pair<double, double> RT::calcSubstractionError(TF1* total, TF1* bkg, double l, double u,
-                                                    bool verbose)
+/**
+ * @brief Signal and its error from the integrals of the total and the background function.
+ */
+std::pair<double, double> RT::calcSubstractionError(double int_t, double int_b, bool verbose)
 {
-    double int_b = bkg->Integral(l, u);
-    double int_t = total->Integral(l, u);
     double s_delta = int_t - int_b;
     double s_error = sqrt(int_t + int_b);
 
@@ -534,32 +720,56 @@ std::pair<double, double> RT::calcSubstractionError(TF1* total, TF1* bkg, double
     return std::pair<double, double>(s_delta, s_error);
 }
 
-double RT::calcTotalError(TH1* h, Int_t bin_l, Int_t bin_u)
+std::pair<double, double> RT::calcSubstractionError(TF1* total, TF1* bkg, double l, double u,
+                                                    bool verbose)
+{
+    return calcSubstractionError(total->Integral(l, u), bkg->Integral(l, u), verbose);
+}
+
+// The calc* helpers work on TH1 and on HistView, which have the same bin access methods.
+template <class H> static double TotalError(const H& h, Int_t bin_l, Int_t bin_u)
 {
     double val = 0.0;
     double val_;
     for (Int_t i = bin_l; i <= bin_u; ++i)
     {
-        val_ = h->GetBinError(i);
+        val_ = h.GetBinError(i);
         val += val_ * val_;
     }
 
     return TMath::Sqrt(val);
 }
 
-double RT::calcTotalError2(TH1* h, Int_t bin_l, Int_t bin_u)
+template <class H> static double TotalError2(const H& h, Int_t bin_l, Int_t bin_u)
 {
     double val = 0.0;
     double val_;
     for (Int_t i = bin_l; i <= bin_u; ++i)
     {
-        val_ = h->GetBinContent(i);
+        val_ = h.GetBinContent(i);
         val += val_;
     }
 
     return TMath::Sqrt(val);
 }
 
+double RT::calcTotalError(TH1* h, Int_t bin_l, Int_t bin_u) { return TotalError(*h, bin_l, bin_u); }
+
+double RT::calcTotalError(const HistView& h, Int_t bin_l, Int_t bin_u)
+{
+    return TotalError(h, bin_l, bin_u);
+}
+
+double RT::calcTotalError2(TH1* h, Int_t bin_l, Int_t bin_u)
+{
+    return TotalError2(*h, bin_l, bin_u);
+}
+
+double RT::calcTotalError2(const HistView& h, Int_t bin_l, Int_t bin_u)
+{
+    return TotalError2(h, bin_l, bin_u);
+}
+
 TNamed* RT::GetObjectFromFile(TFile* f, const TString& name, const TString& suffix)
 {
     TNamed* dest = nullptr;
@@ -579,15 +789,21 @@ TNamed* RT::GetObjectFromFile(TFile* f, const TString& name, const TString& suff
 
 void RT::NicePalette()
 {
-    const Int_t NRGBs = 5;
-    const Int_t NCont = 255;
-    Double_t stops[NRGBs] = {0.00, 0.34, 0.61, 0.84, 1.00};
-    Double_t red[NRGBs] = {0.00, 0.00, 0.87, 1.00, 0.51};
-    Double_t green[NRGBs] = {0.00, 0.81, 1.00, 0.20, 0.00};
-    Double_t blue[NRGBs] = {0.51, 1.00, 0.12, 0.00, 0.00};
+    static Int_t palette_id = -1;
 
-    TColor::CreateGradientColorTable(NRGBs, stops, red, green, blue, NCont);
-    gStyle->SetNumberContours(NCont);
+    if (palette_id < 0)
+    {
+        const Int_t NRGBs = 5;
+        const Int_t NCont = 255;
+        Double_t stops[NRGBs] = {0.00, 0.34, 0.61, 0.84, 1.00};
+        Double_t red[NRGBs] = {0.00, 0.00, 0.87, 1.00, 0.51};
+        Double_t green[NRGBs] = {0.00, 0.81, 1.00, 0.20, 0.00};
+        Double_t blue[NRGBs] = {0.51, 1.00, 0.12, 0.00, 0.00};
+
+        palette_id = Palettes::Create(NRGBs, stops, red, green, blue, NCont);
+    }
+    else
+        Palettes::Use(palette_id);
 
     gStyle->SetOptStat(0);
 }
@@ -642,6 +858,36 @@ void RT::QuickDraw(TVirtualPad* p, TH1* h, const char* opts, UChar_t logbits)
     if (logbits & 0x04) p->SetLogy();
 }
 
+/**
+ * @brief Draws the pyramid level which matches the pixel resolution of the pad.
+ */
+void RT::QuickDraw(TVirtualPad* p, const HistPyramid& pyramid, const char* opts, UChar_t logbits)
+{
+    QuickDraw(p, pyramid.selectLevel(p), opts, logbits);
+}
+
+/**
+ * @brief Draws the graph, optionally decimated to the pixel width of the pad. The decimated copy is
+ * owned by the pad.
+ */
+void RT::QuickDraw(TVirtualPad* p, TGraph* gr, const char* opts, UChar_t logbits, Bool_t decimate)
+{
+    p->cd();
+
+    if (logbits & 0x01) p->SetLogz();
+    if (logbits & 0x02) p->SetLogx();
+    if (logbits & 0x04) p->SetLogy();
+
+    if (decimate)
+    {
+        TGraph* dec = DecimateGraph(gr, p);
+        dec->SetBit(TObject::kCanDelete);
+        dec->Draw(opts);
+    }
+    else
+        gr->Draw(opts);
+}
+
 void RT::DrawStats(TVirtualPad* p, TH1* h, UInt_t flags, Float_t x, Float_t y, Float_t dy)
 {
     p->cd();
@@ -756,12 +1002,17 @@ void RT::MyMath()
     }
 }
 
-void RT::FetchFitInfo(TF1* fun, double& mean, double& width, double& sig, double& bkg, TPad* pad)
+/**
+ * @brief Mean and width of the signal shapes known to FetchFitInfo(), without drawing.
+ *
+ * @param fun fitted function, the shape is recognized by its title: "gaus(0)+gaus(3)", "ggaus",
+ * "dgaus" or "voigt" (FWHM as width)
+ * @param mean output mean
+ * @param width output width
+ * @return false if the shape is not known, mean and width are not changed then
+ */
+bool RT::calcFitInfo(const TF1* fun, double& mean, double& width)
 {
-    (void)sig;
-    (void)bkg;
-    (void)pad;
-
     const char* ftitle = fun->GetTitle();
 
     if (strcmp(ftitle, "gaus(0)+gaus(3)") == 0)
@@ -780,51 +1031,10 @@ void RT::FetchFitInfo(TF1* fun, double& mean, double& width, double& sig, double
         width = (fLambdaFitA1 * fLambdaFitS1 * fLambdaFitS1 +
                  fLambdaFitA2 * fLambdaFitS2 * fLambdaFitS2) /
                 (fLambdaFitA1 * fLambdaFitS1 + fLambdaFitA2 * fLambdaFitS2);
-
-        TLatex* latex = new TLatex();
-        latex->SetNDC();
-        latex->SetTextSize(0.03);
-        latex->DrawLatex(0.57, 0.81, TString::Format("Signal : %s", fun->GetExpFormula().Data()));
-        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fLambdaFitA1));
-        latex->DrawLatex(0.60, 0.74, TString::Format("#mu=%g", fLambdaFitM1));
-        latex->DrawLatex(0.60, 0.71, TString::Format("#sigma=%g", fLambdaFitS1));
-        latex->DrawLatex(0.75, 0.77, TString::Format("A=%g", fLambdaFitA2));
-        latex->DrawLatex(0.75, 0.74, TString::Format("#mu=%g", fLambdaFitM2));
-        latex->DrawLatex(0.75, 0.71, TString::Format("#sigma=%g", fLambdaFitS2));
-
-        latex->DrawLatex(0.60, 0.67, TString::Format("/#mu=%g", mean));
-        latex->DrawLatex(0.60, 0.64, TString::Format("/#sigma=%g", width));
-    }
-
-    if (strcmp(ftitle, "ggaus") == 0)
-    {
-        double fLambdaFitA1 = fun->GetParameter(0);
-        double fLambdaFitA2 = fun->GetParameter(3);
-
-        double fLambdaFitM = fun->GetParameter(1);
-
-        double fLambdaFitS1 = TMath::Abs(fun->GetParameter(2));
-        double fLambdaFitS2 = TMath::Abs(fun->GetParameter(5));
-
-        mean = fLambdaFitM;
-        /* from Wiki about Voigt profile */
-        width = (fLambdaFitA1 * fLambdaFitS1 * fLambdaFitS1 +
-                 fLambdaFitA2 * fLambdaFitS2 * fLambdaFitS2) /
-                (fLambdaFitA1 * fLambdaFitS1 + fLambdaFitA2 * fLambdaFitS2);
-
-        TLatex* latex = new TLatex();
-        latex->SetNDC();
-        latex->SetTextSize(0.03);
-        latex->DrawLatex(0.57, 0.81, TString::Format("Signal : %s", fun->GetTitle()));
-        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fLambdaFitA1));
-        latex->DrawLatex(0.60, 0.74, TString::Format("#sigma=%g", fLambdaFitS1));
-        latex->DrawLatex(0.75, 0.77, TString::Format("A=%g", fLambdaFitA2));
-        latex->DrawLatex(0.75, 0.74, TString::Format("#sigma=%g", fLambdaFitS2));
-        latex->DrawLatex(0.60, 0.64, TString::Format("#mu=%g", fLambdaFitM));
-        latex->DrawLatex(0.75, 0.64, TString::Format("/#sigma=%g", width));
+        return true;
     }
 
-    if (strcmp(ftitle, "dgaus") == 0)
+    if (strcmp(ftitle, "ggaus") == 0 or strcmp(ftitle, "dgaus") == 0)
     {
         double fLambdaFitA1 = fun->GetParameter(0);
         double fLambdaFitA2 = fun->GetParameter(3);
@@ -832,29 +1042,19 @@ void RT::FetchFitInfo(TF1* fun, double& mean, double& width, double& sig, double
         double fLambdaFitM = fun->GetParameter(1);
 
         double fLambdaFitS1 = TMath::Abs(fun->GetParameter(2));
-        double fLambdaFitS2 = TMath::Abs(fun->GetParameter(4));
+        // second width is [5] in ggaus and [4] in dgaus
+        double fLambdaFitS2 = TMath::Abs(fun->GetParameter(ftitle[0] == 'g' ? 5 : 4));
 
         mean = fLambdaFitM;
         /* from Wiki about Voigt profile */
         width = (fLambdaFitA1 * fLambdaFitS1 * fLambdaFitS1 +
                  fLambdaFitA2 * fLambdaFitS2 * fLambdaFitS2) /
                 (fLambdaFitA1 * fLambdaFitS1 + fLambdaFitA2 * fLambdaFitS2);
-
-        TLatex* latex = new TLatex();
-        latex->SetNDC();
-        latex->SetTextSize(0.03);
-        latex->DrawLatex(0.57, 0.81, TString::Format("Signal : %s", fun->GetTitle()));
-        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fLambdaFitA1));
-        latex->DrawLatex(0.60, 0.74, TString::Format("#sigma=%g", fLambdaFitS1));
-        latex->DrawLatex(0.75, 0.77, TString::Format("A=%g", fLambdaFitA2));
-        latex->DrawLatex(0.75, 0.74, TString::Format("#sigma=%g", fLambdaFitS2));
-        latex->DrawLatex(0.60, 0.64, TString::Format("#mu=%g", fLambdaFitM));
-        latex->DrawLatex(0.75, 0.64, TString::Format("/#sigma=%g", width));
+        return true;
     }
 
     if (strcmp(ftitle, "voigt") == 0)
     {
-        double fLambdaFitA = fun->GetParameter(0);
         double fLambdaFitM = fun->GetParameter(1);
         double fLambdaFitSL = fun->GetParameter(2);
         double fLambdaFitSG = fun->GetParameter(3);
@@ -863,17 +1063,105 @@ void RT::FetchFitInfo(TF1* fun, double& mean, double& width, double& sig, double
         /* from Wiki about Voigt profile */
         width = 0.5346 * fLambdaFitSL +
                 TMath::Sqrt(0.2166 * fLambdaFitSL * fLambdaFitSL + fLambdaFitSG * fLambdaFitSG);
+        return true;
+    }
+
+    return false;
+}
 
-        TLatex* latex = new TLatex();
-        latex->SetNDC();
-        latex->SetTextSize(0.03);
+/**
+ * @brief Checks whether the minimizer can be created, e.g. whether ROOT was built with Minuit2.
+ */
+bool RT::HasMinimizer(const char* type)
+{
+    ROOT::Math::Minimizer* min = ROOT::Math::Factory::CreateMinimizer(type);
+    bool found = min != nullptr;
+    delete min;
+
+    return found;
+}
+
+/**
+ * @brief Fits the histogram as TH1::Fit() does, but with the given minimizer instead of the
+ * process-wide default one. The default is neither read nor changed, so fits with different
+ * minimizers can run in parallel threads.
+ *
+ * @param h histogram
+ * @param f fit function
+ * @param options fit options of TH1::Fit()
+ * @param type minimizer type, e.g. "Minuit2"
+ * @param algo minimizer algorithm
+ * @return fit status, 0 for converged
+ */
+Int_t RT::FitWithMinimizer(TH1* h, TF1* f, const char* options, const char* type,
+                           const char* algo)
+{
+    Foption_t fit_option;
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 0, 0)
+    ROOT::Fit::FitOptionsMake(ROOT::Fit::EFitObjectType::kHistogram, options, fit_option);
+#else
+    ROOT::Fit::FitOptionsMake(options, fit_option);
+#endif
+
+    ROOT::Math::MinimizerOptions min_option;
+    min_option.SetMinimizerType(type);
+    min_option.SetMinimizerAlgorithm(algo);
+
+    ROOT::Fit::DataRange range;
+    h->BufferEmpty();
+
+    return ROOT::Fit::FitObject(h, f, fit_option, min_option, "", range);
+}
+
+void RT::FetchFitInfo(TF1* fun, double& mean, double& width, double& sig, double& bkg, TPad* pad)
+{
+    (void)sig;
+    (void)bkg;
+    (void)pad;
+
+    if (!calcFitInfo(fun, mean, width)) return;
+
+    const char* ftitle = fun->GetTitle();
+
+    TLatex* latex = new TLatex();
+    latex->SetNDC();
+    latex->SetTextSize(0.03);
+
+    if (strcmp(ftitle, "gaus(0)+gaus(3)") == 0)
+    {
+        latex->DrawLatex(0.57, 0.81, TString::Format("Signal : %s", fun->GetExpFormula().Data()));
+        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fun->GetParameter(0)));
+        latex->DrawLatex(0.60, 0.74, TString::Format("#mu=%g", fun->GetParameter(1)));
+        latex->DrawLatex(0.60, 0.71, TString::Format("#sigma=%g", fun->GetParameter(2)));
+        latex->DrawLatex(0.75, 0.77, TString::Format("A=%g", fun->GetParameter(3)));
+        latex->DrawLatex(0.75, 0.74, TString::Format("#mu=%g", fun->GetParameter(1)));
+        latex->DrawLatex(0.75, 0.71, TString::Format("#sigma=%g", fun->GetParameter(5)));
+
+        latex->DrawLatex(0.60, 0.67, TString::Format("/#mu=%g", mean));
+        latex->DrawLatex(0.60, 0.64, TString::Format("/#sigma=%g", width));
+    }
+    else if (strcmp(ftitle, "voigt") == 0)
+    {
         latex->DrawLatex(0.57, 0.81, TString::Format("Signal : %s", fun->GetTitle()));
-        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fLambdaFitA));
+        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fun->GetParameter(0)));
         latex->DrawLatex(0.60, 0.74, TString::Format("#mu=%g", mean));
-        latex->DrawLatex(0.60, 0.71, TString::Format("#sigma_{L}=%g", fLambdaFitSL));
-        latex->DrawLatex(0.75, 0.71, TString::Format("#sigma_{G}=%g", fLambdaFitSG));
+        latex->DrawLatex(0.60, 0.71, TString::Format("#sigma_{L}=%g", fun->GetParameter(2)));
+        latex->DrawLatex(0.75, 0.71, TString::Format("#sigma_{G}=%g", fun->GetParameter(3)));
         latex->DrawLatex(0.60, 0.68, TString::Format("FWHM=%g", width));
     }
+    else
+    {
+        // ggaus and dgaus
+        double s1 = TMath::Abs(fun->GetParameter(2));
+        double s2 = TMath::Abs(fun->GetParameter(ftitle[0] == 'g' ? 5 : 4));
+        latex->DrawLatex(0.57, 0.81, TString::Format("Signal : %s", fun->GetTitle()));
+        latex->DrawLatex(0.60, 0.77, TString::Format("A=%g", fun->GetParameter(0)));
+        latex->DrawLatex(0.60, 0.74, TString::Format("#sigma=%g", s1));
+        latex->DrawLatex(0.75, 0.77, TString::Format("A=%g", fun->GetParameter(3)));
+        latex->DrawLatex(0.75, 0.74, TString::Format("#sigma=%g", s2));
+        latex->DrawLatex(0.60, 0.64, TString::Format("#mu=%g", mean));
+        latex->DrawLatex(0.75, 0.64, TString::Format("/#sigma=%g", width));
+    }
 }
 
 // bool RT::Smooth(TH1 * h, int par)
@@ -1251,12 +1539,9 @@ bool RT::FileIsNewer(const char* file, const char* reference)
 auto RT::split(const std::string& s, char delim, std::vector<std::string>& elems)
     -> std::vector<std::string>&
 {
-    std::stringstream ss(s);
-    std::string item;
-    while (std::getline(ss, item, delim))
-    {
-        elems.push_back(item);
-    }
+    for (const Tokenizer::Field& field : Tokenizer(s.data(), s.size(), &delim, 1, EF_DROP_TRAILING))
+        elems.emplace_back(field.data, field.size);
+
     return elems;
 }
 
@@ -1273,43 +1558,36 @@ TF1* RT::makeBarOffsetFunction(TF1* fun, double bar_width_scale)
     fun->Copy(*f);
 
     const size_t npars = fun->GetNpar();
-    double* pars = new double[npars];
-    double* errs = new double[npars];
-
-    // backup original params and errors
-    for (unsigned int i = 0; i < npars; ++i)
-    {
-        pars[i] = fun->GetParameter(i);
-        errs[i] = fun->GetParError(i);
-    }
-
-    // set higher params, integrate
     for (unsigned int i = 0; i < npars; ++i)
-    {
-        f->SetParameter(i, pars[i] + bar_width_scale * errs[i]);
-        f->SetParError(i, errs[i]);
-    }
+        f->SetParameter(i, fun->GetParameter(i) + bar_width_scale * fun->GetParError(i));
 
     return f;
 }
 
 double RT::calcFuncErrorBar(TF1* fun, double x1, double x2, double bar_width_scale, int /*ccolor*/)
 {
+    // integrate with all parameters shifted down and up, evaluated on a private parameter array;
+    // the function is neither copied nor modified (see ErrorBand for errors with correlations)
+    const size_t npars = fun->GetNpar();
+    std::vector<double> shifted(npars);
 
-    TF1* f_l = makeBarOffsetFunction(fun, -bar_width_scale);
-    TF1* f_u = makeBarOffsetFunction(fun, +bar_width_scale);
+    ROOT::Math::Functor1D shifted_fun([&](double x) { return fun->EvalPar(&x, shifted.data()); });
+    // same integrator and tolerances as TF1::Integral()
+    ROOT::Math::IntegratorOneDim integrator(shifted_fun, ROOT::Math::IntegrationOneDim::kDEFAULT,
+                                            1.E-12, 1.E-12);
 
-    double int_u = f_u->Integral(x1, x2);
-    double int_l = f_l->Integral(x1, x2);
+    double ints[2];
+    for (int s = 0; s < 2; ++s)
+    {
+        double scale = s ? bar_width_scale : -bar_width_scale;
+        for (size_t i = 0; i < npars; ++i)
+            shifted[i] = fun->GetParameter(i) + scale * fun->GetParError(i);
 
-    f_l->Delete();
-    f_u->Delete();
-    double delta = fabs(int_u - int_l);
+        ints[s] = integrator.Integral(x1, x2);
+    }
 
-    // 	printf("integrals: l=%g, u=%g, d=%g\n", int_l, int_u, delta);
     // calculate error-band area
-
-    return delta;
+    return fabs(ints[1] - ints[0]);
 }
 
 void RT::copyRelativeErrors(TH1* destination, TH1* source)
@@ -1350,155 +1628,403 @@ void RT::copyRelativeErrors(TH1* destination, TH1* source)
             }
 }
 
-void RT::calcBinomialErrors(TH1* p, TH1* N)
+/**
+ * @brief As copyRelativeErrors(destination, source), but only for the listed bins of the
+ * destination; the axis ranges are not used.
+ */
+void RT::copyRelativeErrors(TH1* destination, TH1* source, const SparseBins& bins)
 {
-    size_t bins_x = p->GetXaxis()->GetNbins();
-    size_t bins_y = p->GetYaxis()->GetNbins();
+    bins.forEach([&](Int_t x, Int_t y) {
+        Double_t bc = source->GetBinContent(x, y);
+        Double_t be = source->GetBinError(x, y);
+
+        if (be != 0)
+            destination->SetBinError(x, y, destination->GetBinContent(x, y) * be / bc);
+        else
+            destination->SetBinError(x, y, 0.0);
+    });
+}
 
-    for (size_t x = 1; x <= bins_x; ++x)
+/**
+ * @brief Cells x in [1, nx], y in [1, ny] visited by the bin loops below. The SparseBins
+ * overloads pass the list of non-empty bins instead, which has the same forEach().
+ */
+struct GridCells
+{
+    template <class H> GridCells(const H& h) : nx(h.GetNbinsX()), ny(h.GetNbinsY()) {}
+
+    template <class F> void forEach(F fn) const
     {
-        for (size_t y = 1; y <= bins_y; ++y)
-        {
-            double _p = p->GetBinContent(x, y);
-            double _n = N->GetBinContent(x, y);
+        for (Int_t x = 1; x <= nx; ++x)
+            for (Int_t y = 1; y <= ny; ++y)
+                fn(x, y);
+    }
 
-            double sigma = sqrt(_p * (1.0 - _p) * _n);
-            p->SetBinError(x, y, sigma / _n);
+    Int_t nx;
+    Int_t ny;
+};
+
+template <class C> static void BinomialErrors(TH1* p, TH1* N, const C& cells)
+{
+    cells.forEach([&](Int_t x, Int_t y) {
+        double _p = p->GetBinContent(x, y);
+        double _n = N->GetBinContent(x, y);
+
+        if (_n <= 0)
+        {
+            p->SetBinError(x, y, 0);
+            return;
         }
-    }
+
+        double sigma = sqrt(_p * (1.0 - _p) * _n);
+        p->SetBinError(x, y, sigma / _n);
+    });
 }
 
-void RT::calcBinomialErrors(TH1* p, TH1* q, TH1* N)
+void RT::calcBinomialErrors(TH1* p, TH1* N) { BinomialErrors(p, N, GridCells(*p)); }
+
+void RT::calcBinomialErrors(TH1* p, TH1* N, const SparseBins& bins)
 {
-    size_t bins_x = p->GetXaxis()->GetNbins();
-    size_t bins_y = p->GetYaxis()->GetNbins();
+    BinomialErrors(p, N, bins);
+}
 
-    for (size_t x = 1; x <= bins_x; ++x)
-    {
-        for (size_t y = 1; y <= bins_y; ++y)
-        {
-            double _p = p->GetBinContent(x, y);
-            double _q = q->GetBinContent(x, y);
-            double _n = N->GetBinContent(x, y);
+template <class C> static void BinomialErrors(TH1* p, TH1* q, TH1* N, const C& cells)
+{
+    cells.forEach([&](Int_t x, Int_t y) {
+        double _p = p->GetBinContent(x, y);
+        double _q = q->GetBinContent(x, y);
+        double _n = N->GetBinContent(x, y);
 
-            double sigma = sqrt(_p * _q * _n);
-            p->SetBinError(x, y, sigma / _n);
+        if (_n <= 0)
+        {
+            p->SetBinError(x, y, 0);
+            return;
         }
-    }
+
+        double sigma = sqrt(_p * _q * _n);
+        p->SetBinError(x, y, sigma / _n);
+    });
+}
+
+void RT::calcBinomialErrors(TH1* p, TH1* q, TH1* N) { BinomialErrors(p, q, N, GridCells(*p)); }
+
+void RT::calcBinomialErrors(TH1* p, TH1* q, TH1* N, const SparseBins& bins)
+{
+    BinomialErrors(p, q, N, bins);
+}
+
+template <class C>
+static void ErrorPropagationMult(TH1* h, double val, double err, const C& cells)
+{
+    cells.forEach([&](Int_t x, Int_t y) {
+        double bc = h->GetBinContent(x, y) / val;
+        double be = h->GetBinError(x, y) / val;
+
+        double sigma = sqrt(val * val * be * be + bc * bc * err * err);
+        h->SetBinError(x, y, sigma);
+    });
 }
 
 void RT::calcErrorPropagationMult(TH1* h, double val, double err)
 {
-    size_t bins_x = h->GetXaxis()->GetNbins();
-    size_t bins_y = h->GetYaxis()->GetNbins();
+    ErrorPropagationMult(h, val, err, GridCells(*h));
+}
 
-    for (size_t x = 1; x <= bins_x; ++x)
-    {
-        for (size_t y = 1; y <= bins_y; ++y)
-        {
-            double bc = h->GetBinContent(x, y) / val;
-            double be = h->GetBinError(x, y) / val;
+void RT::calcErrorPropagationMult(TH1* h, const SparseBins& bins, double val, double err)
+{
+    ErrorPropagationMult(h, val, err, bins);
+}
 
-            double sigma = sqrt(val * val * be * be + bc * bc * err * err);
-            h->SetBinError(x, y, sigma);
-        }
-    }
+template <class C>
+static void ErrorPropagationDiv(TH1* h, double val, double err, const C& cells)
+{
+    cells.forEach([&](Int_t x, Int_t y) {
+        double bc = h->GetBinContent(x, y) * val;
+        double be = h->GetBinError(x, y) * val;
+
+        double sigma = sqrt(val * val * be * be + bc * bc * err * err) / (val * val);
+        h->SetBinError(x, y, sigma);
+    });
 }
 
 void RT::calcErrorPropagationDiv(TH1* h, double val, double err)
 {
-    size_t bins_x = h->GetXaxis()->GetNbins();
-    size_t bins_y = h->GetYaxis()->GetNbins();
+    ErrorPropagationDiv(h, val, err, GridCells(*h));
+}
+
+void RT::calcErrorPropagationDiv(TH1* h, const SparseBins& bins, double val, double err)
+{
+    ErrorPropagationDiv(h, val, err, bins);
+}
 
-    for (size_t x = 1; x <= bins_x; ++x)
+#if defined(__cpp_lib_to_chars)
+/**
+ * @brief Parses a double at p, not past end, independent of the locale.
+ *
+ * @return end of the number, nullptr if there is none
+ */
+static const char* ParseDouble(const char* p, const char* end, double& val)
+{
+    auto res = std::from_chars(p, end, val);
+    return res.ec == std::errc() ? res.ptr : nullptr;
+}
+#else
+static const char* ParseDouble(const char* p, const char* end, double& val)
+{
+    static locale_t c_locale = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+
+    // same syntax as from_chars: no leading '+', and "0x" is a zero followed by other text
+    const char* q = p;
+    if (q != end and *q == '-') ++q;
+    if (q == end or *q == '+') return nullptr;
+    if (*q == '0' and q + 1 != end and (q[1] == 'x' or q[1] == 'X'))
+    {
+        val = q != p ? -0.0 : 0.0;
+        return q + 1;
+    }
+
+    // strtod needs a terminated string, the input is a slice of a larger buffer
+    char buf[64];
+    std::string longer;
+    size_t n = end - p;
+    const char* str = buf;
+    if (n < sizeof(buf))
+    {
+        memcpy(buf, p, n);
+        buf[n] = '\0';
+    }
+    else
+    {
+        longer.assign(p, n);
+        str = longer.c_str();
+    }
+
+    char* stop = nullptr;
+    val = strtod_l(str, &stop, c_locale);
+    if (stop == str) return nullptr;
+
+    return p + (stop - str);
+}
+#endif
+
+/**
+ * @brief Parses one section of an errors string: empty (no error), a symmetric value "v", or
+ * signed values "+h-l" in any order. Whitespace around the values is ignored.
+ *
+ * @param sec section text
+ * @param len section length
+ * @param ep parsed errors
+ * @param bad offset of the first malformed character in the section, on failure
+ * @return true if the section is well formed
+ */
+static bool ParseErrorsSection(const char* sec, size_t len, RT::ErrorsPair& ep, size_t& bad)
+{
+    ep = {0.0, 0.0};
+
+    const char* p = sec;
+    const char* end = p + len;
+
+    auto skip_spaces = [&]() {
+        while (p != end and isspace((unsigned char)*p))
+            ++p;
+    };
+    auto number = [&](double& val) {
+        skip_spaces();
+        const char* stop = ParseDouble(p, end, val);
+        if (!stop) return false;
+        p = stop;
+        skip_spaces();
+        return true;
+    };
+
+    skip_spaces();
+    if (p == end) return true;
+
+    if (*p != '+' and *p != '-')
+    {
+        double val;
+        if (!number(val) or p != end)
+        {
+            bad = p - sec;
+            return false;
+        }
+
+        ep.low = ep.high = val;
+        return true;
+    }
+
+    while (p != end)
     {
-        for (size_t y = 1; y <= bins_y; ++y)
+        char sign = *p;
+        if (sign != '+' and sign != '-')
         {
-            double bc = h->GetBinContent(x, y) * val;
-            double be = h->GetBinError(x, y) * val;
+            bad = p - sec;
+            return false;
+        }
+        ++p;
 
-            double sigma = sqrt(val * val * be * be + bc * bc * err * err) / (val * val);
-            h->SetBinError(x, y, sigma);
+        double val;
+        if (!number(val))
+        {
+            bad = p - sec;
+            return false;
         }
+
+        if (sign == '+')
+            ep.high = val;
+        else
+            ep.low = val;
     }
+
+    return true;
 }
 
-auto RT::errorsStrToArray(const std::string& errors_str) -> std::vector<ErrorsPair>
+/**
+ * @brief Parses the section into the buffer, malformed sections give zero errors and are
+ * reported.
+ */
+static void StoreErrorsSection(const char* sec, size_t len, size_t position, size_t section,
+                               RT::ErrorsPair* buffer, size_t capacity,
+                               std::vector<RT::ErrorsParseIssue>* issues)
 {
-    std::vector<ErrorsPair> errors;
-    size_t global_pos = 0;
-    size_t str_end = errors_str.npos;
+    RT::ErrorsPair ep;
+    size_t bad = 0;
+    if (!ParseErrorsSection(sec, len, ep, bad) and issues)
+        issues->push_back({section, position + bad});
 
-    while (global_pos < str_end)
+    if (section < capacity) buffer[section] = ep;
+}
+
+/**
+ * @brief Parses a string of '|' separated errors, e.g. "0.5|+0.3-0.2|-0.1+0.4|". A section is a
+ * symmetric error "v", or "+h" and "-l" for the high and low error; an empty section is no error.
+ *
+ * No memory is allocated, except for reporting malformed sections.
+ *
+ * @param errors_str errors string, not necessarily terminated
+ * @param length length of the string
+ * @param buffer output, sections beyond capacity are counted but not stored
+ * @param capacity size of the buffer
+ * @param issues if given, malformed sections are added with their positions; they are stored as
+ * zero errors
+ * @return number of sections
+ */
+size_t RT::errorsStrToArray(const char* errors_str, size_t length, ErrorsPair* buffer,
+                            size_t capacity, std::vector<ErrorsParseIssue>* issues)
+{
+    const char* end = errors_str + length;
+    const char* start = errors_str;
+    size_t section = 0;
+    while (true)
     {
-        size_t current_pos = global_pos;
-        size_t section_end = errors_str.find('|', global_pos);
+        const char* bar = (const char*)memchr(start, '|', end - start);
+        const char* stop = bar ? bar : end;
+
+        StoreErrorsSection(start, stop - start, start - errors_str, section++, buffer, capacity,
+                           issues);
 
-        ErrorsPair ep = {0.0, 0.0};
-        std::string str_section = errors_str.substr(current_pos, section_end - current_pos);
+        if (!bar) break;
+        start = bar + 1;
+    }
 
-        size_t control_signs_start = 0;
-        size_t control_signs_stop = 0;
-        size_t str_section_end = str_section.npos;
+    return section;
+}
 
-        while (control_signs_stop != str_section_end)
+size_t RT::errorsStrToArray(const std::string& errors_str, ErrorsPair* buffer, size_t capacity,
+                            std::vector<ErrorsParseIssue>* issues)
+{
+    return errorsStrToArray(errors_str.data(), errors_str.size(), buffer, capacity, issues);
+}
+
+auto RT::errorsStrToArray(const std::string& errors_str, std::vector<ErrorsParseIssue>* issues)
+    -> std::vector<ErrorsPair>
+{
+    std::vector<ErrorsPair> errors(std::count(errors_str.begin(), errors_str.end(), '|') + 1);
+    errorsStrToArray(errors_str, errors.data(), errors.size(), issues);
+
+    return errors;
+}
+
+/**
+ * @brief Streaming variant of errorsStrToArray(), parses the whole file as one errors string
+ * (line breaks count as whitespace) in chunks of fixed size.
+ *
+ * @param filename input file
+ * @param buffer output, sections beyond capacity are counted but not stored
+ * @param capacity size of the buffer
+ * @param issues if given, malformed sections are added with their file offsets
+ * @return number of sections, (size_t)-1 if the file can't be read
+ */
+size_t RT::errorsFileToArray(const char* filename, ErrorsPair* buffer, size_t capacity,
+                             std::vector<ErrorsParseIssue>* issues)
+{
+    FILE* fp = fopen(filename, "rb");
+    if (!fp)
+    {
+        perror(filename);
+        return (size_t)-1;
+    }
+
+    char chunk[1 << 16];
+    size_t filled = 0;
+    size_t offset = 0; // file offset of chunk[0]
+    size_t section = 0;
+    bool overlong = false;
+
+    auto emit = [&](size_t start, size_t stop) {
+        // begin of this section did not fit into the chunk and was already reported
+        if (overlong)
         {
-            control_signs_stop = str_section.find_first_of("+-", control_signs_start);
+            overlong = false;
+            if (section < capacity) buffer[section] = {0.0, 0.0};
+            ++section;
+            return;
+        }
 
-            if (control_signs_start != control_signs_stop)
-            {
-                std::string sub_section =
-                    str_section.substr(control_signs_start, control_signs_stop);
+        StoreErrorsSection(chunk + start, stop - start, offset + start, section++, buffer,
+                           capacity, issues);
+    };
 
-                if (control_signs_stop == str_section_end)
-                {
-                    if (sub_section.length()) ep.low = ep.high = std::stod(sub_section);
-                    break;
-                }
-                else
-                {
-                    ep.low = ep.high = std::stod(sub_section);
-                    // 					continue;
-                    break;
-                }
-            }
+    while (true)
+    {
+        size_t n = fread(chunk + filled, 1, sizeof(chunk) - filled, fp);
+        filled += n;
 
-            if (control_signs_start == control_signs_stop)
-            {
-                control_signs_stop = str_section.find_first_of("+-", control_signs_start + 1);
+        size_t start = 0;
+        const char* bar;
+        while ((bar = (const char*)memchr(chunk + start, '|', filled - start)))
+        {
+            emit(start, bar - chunk);
+            start = bar - chunk + 1;
+        }
 
-                if (str_section[control_signs_start] == '+')
-                {
-                    std::string sub_section =
-                        str_section.substr(control_signs_start + 1,
-                                           control_signs_stop == str_section_end
-                                               ? str_section_end
-                                               : control_signs_stop - 2 - control_signs_start + 1);
-                    ep.high = std::stod(sub_section);
-                }
-                if (str_section[control_signs_start] == '-')
-                {
-                    std::string sub_section =
-                        str_section.substr(control_signs_start + 1,
-                                           control_signs_stop == str_section_end
-                                               ? str_section_end
-                                               : control_signs_stop - 2 - control_signs_start + 1);
-                    ep.low = std::stod(sub_section);
-                }
-            }
+        if (n == 0)
+        {
+            emit(start, filled);
+            break;
+        }
 
-            control_signs_start = control_signs_stop;
+        if (start == 0 and filled == sizeof(chunk))
+        {
+            // section longer than the chunk, it can't be a valid errors pair
+            if (!overlong and issues) issues->push_back({section, offset});
+            overlong = true;
+            start = filled;
         }
-        errors.push_back(ep);
-        global_pos = section_end + 1;
 
-        // 		printf(" found errors pair: low=%g    high=%g    from %s\n", ep.low, ep.high,
-        // errors_str.c_str());
+        memmove(chunk, chunk + start, filled - start);
+        offset += start;
+        filled -= start;
+    }
 
-        if (section_end == str_end) break;
+    if (ferror(fp))
+    {
+        perror(filename);
+        section = (size_t)-1;
     }
+    fclose(fp);
 
-    return errors;
+    return section;
 }
 
 double RT::calcTotalError(const std::vector<ErrorsPair>& errschain, double& err_u, double& err_l)
@@ -1519,77 +2045,85 @@ double RT::calcTotalError(const std::vector<ErrorsPair>& errschain, double& err_
     return err;
 }
 
-double RT::calcTotalError(TH1* h, bool verbose)
+template <class H, class C> static double TotalError(const H& h, const C& cells, bool verbose)
 {
-    size_t bins_x = h->GetXaxis()->GetNbins();
-    size_t bins_y = h->GetYaxis()->GetNbins();
-
     double total_err = 0.0;
-    for (size_t x = 1; x <= bins_x; ++x)
-    {
-        for (size_t y = 1; y <= bins_y; ++y)
+    cells.forEach([&](Int_t x, Int_t y) {
+        double err = h.GetBinError(x, y);
+        if (err != 0.0)
         {
-            double err = h->GetBinError(x, y);
-            if (err != 0.0)
-            {
-                total_err += err * err;
-                if (verbose)
-                    printf("[%lu, %lu] Adding %g * %g = %g -> %g\n", x, y, err, err, err * err,
-                           total_err);
-            }
+            total_err += err * err;
+            if (verbose)
+                printf("[%d, %d] Adding %g * %g = %g -> %g\n", x, y, err, err, err * err,
+                       total_err);
         }
-    }
+    });
 
     printf("  sqrt(%g) = %g\n", total_err, sqrt(total_err));
     return sqrt(total_err);
 }
 
-double RT::calcTotalContent(TH1* h, bool verbose)
+double RT::calcTotalError(TH1* h, bool verbose) { return TotalError(*h, GridCells(*h), verbose); }
+
+double RT::calcTotalError(const HistView& h, bool verbose)
+{
+    return TotalError(h, GridCells(h), verbose);
+}
+
+double RT::calcTotalError(TH1* h, const SparseBins& bins, bool verbose)
 {
-    size_t bins_x = h->GetXaxis()->GetNbins();
-    size_t bins_y = h->GetYaxis()->GetNbins();
+    return TotalError(*h, bins, verbose);
+}
 
+template <class H, class C> static double TotalContent(const H& h, const C& cells, bool verbose)
+{
     double total_content = 0.0;
-    for (size_t x = 1; x <= bins_x; ++x)
-    {
-        for (size_t y = 1; y <= bins_y; ++y)
+    cells.forEach([&](Int_t x, Int_t y) {
+        double cont = h.GetBinContent(x, y);
+        if (cont != 0.0)
         {
-            double cont = h->GetBinContent(x, y);
-            if (cont != 0.0)
-            {
-                total_content += cont;
-                if (verbose) printf("[%lu, %lu] Adding %g -> %g\n", x, y, cont, total_content);
-            }
+            total_content += cont;
+            if (verbose) printf("[%d, %d] Adding %g -> %g\n", x, y, cont, total_content);
         }
-    }
+    });
 
     printf("  content = %g\n", total_content);
     return total_content;
 }
 
-void RT::calcTotalHistogramValues(TH1* h, double& content, double& error, bool verbose)
+double RT::calcTotalContent(TH1* h, bool verbose)
 {
-    size_t bins_x = h->GetXaxis()->GetNbins();
-    size_t bins_y = h->GetYaxis()->GetNbins();
+    return TotalContent(*h, GridCells(*h), verbose);
+}
+
+double RT::calcTotalContent(const HistView& h, bool verbose)
+{
+    return TotalContent(h, GridCells(h), verbose);
+}
 
+double RT::calcTotalContent(TH1* h, const SparseBins& bins, bool verbose)
+{
+    return TotalContent(*h, bins, verbose);
+}
+
+template <class H, class C>
+static void TotalHistogramValues(const H& h, const C& cells, double& content, double& error,
+                                 bool verbose)
+{
     double total_content = 0.0;
     double total_err = 0.0;
-    for (size_t x = 1; x <= bins_x; ++x)
-    {
-        for (size_t y = 1; y <= bins_y; ++y)
-        {
-            double cont = h->GetBinContent(x, y);
-            double err = h->GetBinError(x, y);
+    cells.forEach([&](Int_t x, Int_t y) {
+        double cont = h.GetBinContent(x, y);
+        double err = h.GetBinError(x, y);
 
-            total_content += cont;
-            total_err += err * err;
-            if (verbose)
-            {
-                printf("[%lu, %lu] V: %g -> %g  E: %g * %g = %g -> %g\n", x, y, cont, total_content,
-                       err, err, err * err, total_err);
-            }
+        total_content += cont;
+        total_err += err * err;
+        if (verbose)
+        {
+            printf("[%d, %d] V: %g -> %g  E: %g * %g = %g -> %g\n", x, y, cont, total_content, err,
+                   err, err * err, total_err);
         }
-    }
+    });
 
     content = total_content;
     error = sqrt(total_err);
@@ -1597,27 +2131,51 @@ void RT::calcTotalHistogramValues(TH1* h, double& content, double& error, bool v
     printf("  content = %g  sqrt(%g) = %g\n", content, total_err, error);
 }
 
-TH1* RT::makeRelativeErrorHistogram(TH1* h, bool percentage)
+void RT::calcTotalHistogramValues(TH1* h, double& content, double& error, bool verbose)
+{
+    TotalHistogramValues(*h, GridCells(*h), content, error, verbose);
+}
+
+void RT::calcTotalHistogramValues(const HistView& h, double& content, double& error,
+                                  bool verbose)
+{
+    TotalHistogramValues(h, GridCells(h), content, error, verbose);
+}
+
+void RT::calcTotalHistogramValues(TH1* h, const SparseBins& bins, double& content, double& error,
+                                  bool verbose)
+{
+    TotalHistogramValues(*h, bins, content, error, verbose);
+}
+
+template <class C> static TH1* RelativeErrorHistogram(TH1* h, bool percentage, const C& cells)
 {
     TH1* re = (TH1*)h->Clone();
     re->Reset();
 
-    size_t bins_x = h->GetXaxis()->GetNbins();
-    size_t bins_y = h->GetYaxis()->GetNbins();
-
-    for (size_t x = 1; x <= bins_x; ++x)
-    {
-        for (size_t y = 1; y <= bins_y; ++y)
-        {
-            double cont = h->GetBinContent(x, y);
-            double err = h->GetBinError(x, y);
+    cells.forEach([&](Int_t x, Int_t y) {
+        double cont = h->GetBinContent(x, y);
+        double err = h->GetBinError(x, y);
 
-            if (percentage)
-                re->SetBinContent(x, y, err / cont * 100.0);
-            else
-                re->SetBinContent(x, y, err / cont);
-        }
-    }
+        if (percentage)
+            re->SetBinContent(x, y, err / cont * 100.0);
+        else
+            re->SetBinContent(x, y, err / cont);
+    });
 
     return re;
 }
+
+TH1* RT::makeRelativeErrorHistogram(TH1* h, bool percentage)
+{
+    return RelativeErrorHistogram(h, percentage, GridCells(*h));
+}
+
+/**
+ * @brief As makeRelativeErrorHistogram(h, percentage), but bins which are not listed are left
+ * zero instead of 0/0.
+ */
+TH1* RT::makeRelativeErrorHistogram(TH1* h, const SparseBins& bins, bool percentage)
+{
+    return RelativeErrorHistogram(h, percentage, bins);
+}
@@ -0,0 +1,64 @@
+#include "SparseBins.h"
+
+#include <TError.h>
+
+using namespace RT;
+
+SparseBins::SparseBins(const TH1* h) : nx(0), ny(0) { build(h); }
+
+/**
+ * @brief Scans all bins of the histogram and lists the non-empty ones in bin order.
+ */
+void SparseBins::build(const TH1* h)
+{
+    bins.clear();
+    mask.clear();
+    nx = ny = 0;
+
+    if (h->GetDimension() > 2)
+    {
+        Error("SparseBins", "Only 1D and 2D histograms are supported, %s is %dD", h->GetName(),
+              h->GetDimension());
+        return;
+    }
+
+    nx = h->GetNbinsX();
+    ny = h->GetDimension() == 2 ? h->GetNbinsY() : 0;
+    mask.assign(getNcells(), false);
+
+    const Double_t* sumw2 = h->GetSumw2N() ? h->GetSumw2()->GetArray() : nullptr;
+
+    Int_t y_first = ny ? 1 : 0;
+    Int_t y_last = ny;
+    for (Int_t y = y_first; y <= y_last; ++y)
+    {
+        for (Int_t x = 1; x <= nx; ++x)
+        {
+            Int_t bin = x + (nx + 2) * y;
+            if (h->GetBinContent(bin) != 0.0 or (sumw2 and sumw2[bin] != 0.0))
+            {
+                bins.push_back(bin);
+                mask[bin] = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lists the bin if it is not listed yet. Under- and overflow bins and negative bin
+ * numbers (as returned by TH1::Fill for buffered or rejected fills) are ignored.
+ *
+ * @param bin global bin number
+ */
+void SparseBins::update(Int_t bin)
+{
+    if (bin < 0 or bin >= getNcells() or mask[bin]) return;
+
+    Int_t x = bin % (nx + 2);
+    Int_t y = bin / (nx + 2);
+    if (x < 1 or x > nx) return;
+    if (ny and (y < 1 or y > ny)) return;
+
+    bins.push_back(bin);
+    mask[bin] = true;
+}
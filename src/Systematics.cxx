@@ -0,0 +1,173 @@
+#include "Systematics.h"
+
+#include <TError.h>
+#include <TH1.h>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+using namespace RT;
+
+// Kernels over contiguous arrays, simple enough to be vectorized by the compiler.
+
+static inline void AddLinear(Double_t* __restrict acc, const Double_t* __restrict v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        acc[i] += v[i];
+}
+
+static inline void AddSquares(Double_t* __restrict acc, const Double_t* __restrict v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        acc[i] += v[i] * v[i];
+}
+
+static inline void Sqrt(Double_t* v, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        v[i] = sqrt(v[i]);
+}
+
+SystematicsTable::SystematicsTable(size_t bins) : bins(bins) {}
+
+SystematicsTable::SystematicsTable(const TH1* h) : bins(h->GetNcells()) {}
+
+/**
+ * @brief Adds a source with zero errors.
+ *
+ * @param name source name
+ * @param group correlation group, sources with the same non-negative group are fully correlated
+ * @return index of the source
+ */
+size_t SystematicsTable::addSource(const TString& name, Int_t group)
+{
+    names.push_back(name);
+    groups.push_back(group);
+
+    high_errs.resize(names.size() * bins, 0.0);
+    low_errs.resize(names.size() * bins, 0.0);
+
+    return names.size() - 1;
+}
+
+/**
+ * @brief Sets errors of all bins of the source, e.g. from errorsStrToArray().
+ */
+void SystematicsTable::setErrors(size_t source, const ErrorsPair* errors)
+{
+    Double_t* h = getHigh(source);
+    Double_t* l = getLow(source);
+    for (size_t i = 0; i < bins; ++i)
+    {
+        h[i] = errors[i].high;
+        l[i] = errors[i].low;
+    }
+}
+
+void SystematicsTable::setErrors(size_t source, const Double_t* high, const Double_t* low)
+{
+    std::copy(high, high + bins, getHigh(source));
+    std::copy(low, low + bins, getLow(source));
+}
+
+void SystematicsTable::combineArrays(const Double_t* high, const Double_t* low, size_t n,
+                                     Double_t* out_high, Double_t* out_low) const
+{
+    std::fill(out_high, out_high + n, 0.0);
+    std::fill(out_low, out_low + n, 0.0);
+
+    std::set<Int_t> used_groups;
+    for (size_t s = 0; s < names.size(); ++s)
+    {
+        if (groups[s] < 0)
+        {
+            AddSquares(out_high, high + s * n, n);
+            AddSquares(out_low, low + s * n, n);
+        }
+        else
+            used_groups.insert(groups[s]);
+    }
+
+    std::vector<Double_t> group_high, group_low;
+    for (Int_t g : used_groups)
+    {
+        group_high.assign(n, 0.0);
+        group_low.assign(n, 0.0);
+
+        for (size_t s = 0; s < names.size(); ++s)
+        {
+            if (groups[s] != g) continue;
+
+            AddLinear(group_high.data(), high + s * n, n);
+            AddLinear(group_low.data(), low + s * n, n);
+        }
+
+        AddSquares(out_high, group_high.data(), n);
+        AddSquares(out_low, group_low.data(), n);
+    }
+
+    Sqrt(out_high, n);
+    Sqrt(out_low, n);
+}
+
+/**
+ * @brief Combined errors of every bin.
+ *
+ * @param high output array of getBins() size
+ * @param low output array of getBins() size
+ */
+void SystematicsTable::combine(Double_t* high, Double_t* low) const
+{
+    combineArrays(high_errs.data(), low_errs.data(), bins, high, low);
+}
+
+/**
+ * @brief Total errors of the sum of all bins, every source is fully correlated between the bins.
+ */
+void SystematicsTable::total(Double_t& high, Double_t& low) const
+{
+    std::vector<Double_t> sum_high(names.size(), 0.0);
+    std::vector<Double_t> sum_low(names.size(), 0.0);
+    for (size_t s = 0; s < names.size(); ++s)
+    {
+        const Double_t* h = &high_errs[s * bins];
+        const Double_t* l = &low_errs[s * bins];
+        for (size_t i = 0; i < bins; ++i)
+        {
+            sum_high[s] += h[i];
+            sum_low[s] += l[i];
+        }
+    }
+
+    combineArrays(sum_high.data(), sum_low.data(), 1, &high, &low);
+}
+
+/**
+ * @brief Sets the bin errors of the histogram to the combined systematic errors in one pass over
+ * its Sumw2 array. TH1 errors are symmetric, the larger of the high and low error is used.
+ *
+ * @param h histogram, the table must have been created for a histogram with the same cells
+ * @param add_to_stat add in quadrature to the existing (statistical) errors
+ */
+void SystematicsTable::apply(TH1* h, Bool_t add_to_stat) const
+{
+    if ((size_t)h->GetNcells() != bins)
+    {
+        Error("SystematicsTable::apply", "Histogram %s has %d cells, table has %zu bins",
+              h->GetName(), h->GetNcells(), bins);
+        return;
+    }
+
+    if (!h->GetSumw2N()) h->Sumw2();
+    Double_t* sumw2 = h->GetSumw2()->GetArray();
+
+    std::vector<Double_t> high(bins), low(bins);
+    combine(high.data(), low.data());
+
+    for (size_t i = 0; i < bins; ++i)
+    {
+        Double_t e = std::max(high[i], low[i]);
+        sumw2[i] = (add_to_stat ? sumw2[i] : 0.0) + e * e;
+    }
+}
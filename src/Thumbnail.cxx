@@ -0,0 +1,303 @@
+#include "Thumbnail.h"
+
+#include <TASImage.h>
+#include <TColor.h>
+#include <TROOT.h>
+#include <TStyle.h>
+
+#include <cfloat>
+#include <cmath>
+
+using namespace RT;
+
+static RT::Hist::PadFormat DefaultPadFormat()
+{
+    RT::Hist::PadFormat format;
+    RT::Hist::def(format);
+    return format;
+}
+
+Thumbnail::Thumbnail(UInt_t width, UInt_t height)
+    : Thumbnail(width, height, DefaultPadFormat())
+{
+}
+
+Thumbnail::Thumbnail(UInt_t width, UInt_t height, const Hist::PadFormat& format)
+    : width(width), height(height), pad_format(format), background(0xffffffff)
+{
+    fx1 = format.marginLeft * width;
+    fx2 = (1.0 - format.marginRight) * width - 1;
+    fy1 = format.marginTop * height;
+    fy2 = (1.0 - format.marginBottom) * height - 1;
+
+    if (fx2 < fx1) fx2 = fx1;
+    if (fy2 < fy1) fy2 = fy1;
+
+    loadStylePalette();
+}
+
+/**
+ * @brief Uses palette created with RT::Palettes::Create(). Invalid id selects the current gStyle
+ * palette.
+ *
+ * @param palette_id palette index
+ */
+void Thumbnail::setPalette(Int_t palette_id)
+{
+    const Int_t* colors = Palettes::GetColors(palette_id);
+    if (!colors)
+    {
+        loadStylePalette();
+        return;
+    }
+
+    Int_t ncolors = Palettes::GetNColors(palette_id);
+    palette.resize(ncolors);
+    for (Int_t i = 0; i < ncolors; ++i)
+        palette[i] = colorToARGB(colors[i]);
+}
+
+void Thumbnail::setBackground(Int_t color) { background = colorToARGB(color); }
+
+/**
+ * @brief Renders the histogram.
+ *
+ * @param h histogram, TH1 or TH2
+ * @param opts "P" draws TH1 with markers, "LP" with line and markers
+ * @param logbits as in QuickDraw(): 0x01 - log z (TH2), 0x04 - log y (TH1)
+ * @return ARGB32 pixels, empty for histograms of other dimensions
+ */
+auto Thumbnail::render(const TH1* h, const char* opts, UChar_t logbits) const
+    -> std::vector<UInt_t>
+{
+    std::vector<UInt_t> pixels;
+
+    Int_t dim = h->GetDimension();
+    if (dim != 1 and dim != 2) return pixels;
+
+    pixels.assign(width * height, background);
+
+    if (dim == 1)
+        renderTH1(pixels, h, opts, logbits);
+    else
+        renderTH2(pixels, h, logbits);
+
+    drawFrame(pixels);
+
+    return pixels;
+}
+
+/**
+ * @brief Creates image from rendered pixels. Not thread-safe.
+ *
+ * @param pixels pixels from render()
+ * @return new image, owned by the caller
+ */
+TASImage* Thumbnail::toImage(const std::vector<UInt_t>& pixels) const
+{
+    TASImage* img = new TASImage(width, height);
+    UInt_t* argb = img->GetArgbArray();
+    if (argb and pixels.size() == width * height) std::copy(pixels.begin(), pixels.end(), argb);
+
+    return img;
+}
+
+Bool_t Thumbnail::writeImage(const TH1* h, const TString& filename, const char* opts,
+                             UChar_t logbits) const
+{
+    std::vector<UInt_t> pixels = render(h, opts, logbits);
+    if (pixels.empty()) return kFALSE;
+
+    TASImage* img = toImage(pixels);
+    Bool_t valid = img->IsValid();
+    if (valid) img->WriteImage(filename);
+    delete img;
+
+    return valid;
+}
+
+UInt_t Thumbnail::colorToARGB(Int_t color)
+{
+    TColor* c = gROOT->GetColor(color);
+    if (!c) return 0xff000000;
+
+    UInt_t a = c->GetAlpha() * 255;
+    UInt_t r = c->GetRed() * 255;
+    UInt_t g = c->GetGreen() * 255;
+    UInt_t b = c->GetBlue() * 255;
+
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+void Thumbnail::loadStylePalette()
+{
+    Int_t ncolors = gStyle->GetNumberOfColors();
+    palette.resize(ncolors);
+    for (Int_t i = 0; i < ncolors; ++i)
+        palette[i] = colorToARGB(gStyle->GetColorPalette(i));
+}
+
+void Thumbnail::renderTH1(std::vector<UInt_t>& pixels, const TH1* h, const char* opts,
+                          UChar_t logbits) const
+{
+    const TAxis* xaxis = h->GetXaxis();
+    Int_t first = xaxis->GetFirst();
+    Int_t last = xaxis->GetLast();
+
+    Double_t xmin = xaxis->GetBinLowEdge(first);
+    Double_t xmax = xaxis->GetBinUpEdge(last);
+
+    bool logy = logbits & 0x04;
+
+    Double_t ymin = logy ? FLT_MAX : 0.0;
+    Double_t ymax = logy ? 0.0 : -FLT_MAX;
+    for (Int_t i = first; i <= last; ++i)
+    {
+        Double_t bc = h->GetBinContent(i);
+        if (logy and bc <= 0) continue;
+        if (bc < ymin) ymin = bc;
+        if (bc > ymax) ymax = bc;
+    }
+
+    if (logy)
+    {
+        if (ymax <= 0) return;
+        ymin = log10(ymin * 0.5);
+        ymax = log10(ymax * 2.0);
+    }
+    else
+        ymax += 0.1 * (ymax - ymin);
+
+    if (ymax <= ymin) ymax = ymin + 1.0;
+
+    auto px = [&](Double_t x) -> Int_t
+    { return fx1 + std::lround((x - xmin) / (xmax - xmin) * (fx2 - fx1)); };
+    auto py = [&](Double_t y) -> Int_t
+    {
+        if (logy) y = y > 0 ? log10(y) : ymin;
+        Double_t t = (y - ymin) / (ymax - ymin);
+        if (t < 0) t = 0;
+        if (t > 1) t = 1;
+        return fy2 - std::lround(t * (fy2 - fy1));
+    };
+
+    TString o = opts;
+    o.ToUpper();
+    bool markers = o.Contains("P");
+    bool line = !markers or o.Contains("L") or o.Contains("HIST");
+
+    if (line)
+    {
+        UInt_t argb = colorToARGB(h->GetLineColor());
+        Int_t lw = h->GetLineWidth() > 1 ? h->GetLineWidth() : 1;
+        Int_t lo = (lw - 1) / 2;
+        Int_t hi = lw - 1 - lo;
+
+        Int_t prev_y = fy2;
+        Int_t x2 = fx1;
+        for (Int_t i = first; i <= last; ++i)
+        {
+            Int_t x1 = px(xaxis->GetBinLowEdge(i));
+            x2 = px(xaxis->GetBinUpEdge(i));
+            Int_t y = py(h->GetBinContent(i));
+
+            fillRect(pixels, x1 - lo, prev_y, x1 + hi, y, argb);
+            fillRect(pixels, x1, y - lo, x2, y + hi, argb);
+            prev_y = y;
+        }
+        fillRect(pixels, x2 - lo, prev_y, x2 + hi, fy2, argb);
+    }
+
+    if (markers)
+    {
+        UInt_t argb = colorToARGB(h->GetMarkerColor());
+        Int_t ms = h->GetMarkerSize() * 2 > 1 ? h->GetMarkerSize() * 2 : 1;
+
+        for (Int_t i = first; i <= last; ++i)
+        {
+            Double_t bc = h->GetBinContent(i);
+            if (logy and bc <= 0) continue;
+
+            Int_t x = px(xaxis->GetBinCenter(i));
+            Int_t y = py(bc);
+            fillRect(pixels, x - ms, y - ms, x + ms, y + ms, argb);
+        }
+    }
+}
+
+void Thumbnail::renderTH2(std::vector<UInt_t>& pixels, const TH1* h, UChar_t logbits) const
+{
+    if (palette.empty()) return;
+
+    const TAxis* xaxis = h->GetXaxis();
+    const TAxis* yaxis = h->GetYaxis();
+    Int_t xfirst = xaxis->GetFirst();
+    Int_t xlast = xaxis->GetLast();
+    Int_t yfirst = yaxis->GetFirst();
+    Int_t ylast = yaxis->GetLast();
+
+    Double_t xmin = xaxis->GetBinLowEdge(xfirst);
+    Double_t xmax = xaxis->GetBinUpEdge(xlast);
+    Double_t ymin = yaxis->GetBinLowEdge(yfirst);
+    Double_t ymax = yaxis->GetBinUpEdge(ylast);
+
+    bool logz = logbits & 0x01;
+
+    Double_t zmin = FLT_MAX;
+    Double_t zmax = -FLT_MAX;
+    for (Int_t by = yfirst; by <= ylast; ++by)
+        for (Int_t bx = xfirst; bx <= xlast; ++bx)
+        {
+            Double_t bc = h->GetBinContent(bx, by);
+            if (bc == 0.0 or (logz and bc < 0)) continue;
+            if (bc < zmin) zmin = bc;
+            if (bc > zmax) zmax = bc;
+        }
+
+    if (zmax < zmin) return;
+
+    if (logz)
+    {
+        zmin = log10(zmin);
+        zmax = log10(zmax);
+    }
+    if (zmax <= zmin) zmax = zmin + 1.0;
+
+    // pixel to bin mapping, computed once per column and row
+    const Int_t ncols = fx2 - fx1 + 1;
+    std::vector<Int_t> colbins(ncols);
+    for (Int_t x = 0; x < ncols; ++x)
+        colbins[x] = xaxis->FindFixBin(xmin + (x + 0.5) / ncols * (xmax - xmin));
+
+    const Int_t nrows = fy2 - fy1 + 1;
+    std::vector<Int_t> rowbins(nrows);
+    for (Int_t y = 0; y < nrows; ++y)
+        rowbins[y] = yaxis->FindFixBin(ymax - (y + 0.5) / nrows * (ymax - ymin));
+
+    const Int_t ncolors = palette.size();
+    for (Int_t y = fy1; y <= fy2; ++y)
+    {
+        UInt_t* row = &pixels[y * width];
+        for (Int_t x = fx1; x <= fx2; ++x)
+        {
+            Double_t bc = h->GetBinContent(colbins[x - fx1], rowbins[y - fy1]);
+            if (bc == 0.0 or (logz and bc < 0)) continue;
+
+            Double_t z = logz ? log10(bc) : bc;
+            Int_t idx = (z - zmin) / (zmax - zmin) * ncolors;
+            if (idx < 0) idx = 0;
+            if (idx >= ncolors) idx = ncolors - 1;
+
+            row[x] = palette[idx];
+        }
+    }
+}
+
+void Thumbnail::drawFrame(std::vector<UInt_t>& pixels) const
+{
+    const UInt_t argb = 0xff000000;
+    fillRect(pixels, fx1, fy1, fx2, fy1, argb);
+    fillRect(pixels, fx1, fy2, fx2, fy2, argb);
+    fillRect(pixels, fx1, fy1, fx1, fy2, argb);
+    fillRect(pixels, fx2, fy1, fx2, fy2, argb);
+}
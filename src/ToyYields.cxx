@@ -0,0 +1,237 @@
+#include "ToyYields.h"
+
+#include "Parallel.h"
+#include "RootTools.h"
+
+#include <TError.h>
+#include <TF1.h>
+#include <TH1.h>
+#include <TRandom3.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace RT;
+
+static std::vector<double> FiniteYields(const std::vector<double>& yields)
+{
+    std::vector<double> v;
+    v.reserve(yields.size());
+    for (double y : yields)
+        if (std::isfinite(y)) v.push_back(y);
+
+    return v;
+}
+
+double ToyResult::mean() const
+{
+    std::vector<double> v = FiniteYields(yields);
+    if (v.empty()) return 0.0;
+
+    double sum = 0.0;
+    for (double y : v)
+        sum += y;
+
+    return sum / v.size();
+}
+
+double ToyResult::rms() const
+{
+    std::vector<double> v = FiniteYields(yields);
+    if (v.size() < 2) return 0.0;
+
+    double m = mean();
+    double sum = 0.0;
+    for (double y : v)
+        sum += (y - m) * (y - m);
+
+    return sqrt(sum / (v.size() - 1));
+}
+
+/**
+ * @brief Quantile of the successful toys, linearly interpolated between them.
+ *
+ * @param q probability in [0, 1]
+ */
+double ToyResult::quantile(double q) const
+{
+    std::vector<double> v = FiniteYields(yields);
+    if (v.empty()) return 0.0;
+
+    std::sort(v.begin(), v.end());
+
+    double pos = std::min(std::max(q, 0.0), 1.0) * (v.size() - 1);
+    size_t i = (size_t)pos;
+    if (i + 1 >= v.size()) return v.back();
+
+    return v[i] + (pos - i) * (v[i + 1] - v[i]);
+}
+
+/**
+ * @brief Histogram of the yields of the successful toys, owned by the caller.
+ */
+TH1* ToyResult::makeHistogram(const char* name, Int_t nbins) const
+{
+    std::vector<double> v = FiniteYields(yields);
+    double min = v.empty() ? 0.0 : *std::min_element(v.begin(), v.end());
+    double max = v.empty() ? 1.0 : *std::max_element(v.begin(), v.end());
+    if (max <= min) max = min + 1.0;
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+    TH1* h = new TH1D(name, ";yield;toys", nbins, min, max + (max - min) * 1e-9);
+    TH1::AddDirectory(add_dir);
+
+    for (double y : v)
+        h->Fill(y);
+
+    return h;
+}
+
+/**
+ * @brief Seed of toy i, a splitmix64 hash of the seed and i; never 0, which TRandom3 would take
+ * from the clock.
+ */
+static UInt_t ToySeed(ULong64_t seed, size_t i)
+{
+    ULong64_t z = seed + (i + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+
+    UInt_t s = z & 0xffffffff;
+    return s ? s : 1;
+}
+
+/**
+ * @param data data histogram, 1D
+ * @param total signal plus background function, used as the fit model
+ * @param bkg background function
+ * @param workers number of threads, 0 for one per CPU
+ */
+ToyYields::ToyYields(const TH1* data, const TF1* total, const TF1* bkg, UInt_t workers)
+    : data(data), total(total), bkg(bkg), workers(GetWorkers(workers)), mode(TM_POISSON),
+      seed(4357), fit_options("QNR"), range_l(0), range_u(0), bkg_offset(-1)
+{
+    EnableThreadSafety();
+}
+
+void ToyYields::generate(TH1* toy, size_t i) const
+{
+    TRandom3 rnd(ToySeed(seed, i));
+
+    Int_t nbins = data->GetNbinsX();
+    toy->Reset();
+
+    if (mode == TM_POISSON)
+    {
+        for (Int_t b = 1; b <= nbins; ++b)
+        {
+            double c = data->GetBinContent(b);
+            toy->SetBinContent(b, c > 0 ? rnd.PoissonD(c) : 0.0);
+        }
+    }
+    else
+    {
+        std::vector<double> cdf(nbins);
+        double sum = 0.0;
+        for (Int_t b = 1; b <= nbins; ++b)
+        {
+            sum += std::max(data->GetBinContent(b), 0.0);
+            cdf[b - 1] = sum;
+        }
+
+        std::vector<double> counts(nbins, 0.0);
+        Long64_t n = llround(sum);
+        for (Long64_t k = 0; k < n; ++k)
+        {
+            size_t b = std::upper_bound(cdf.begin(), cdf.end(), rnd.Rndm() * sum) - cdf.begin();
+            if (b < counts.size()) counts[b] += 1.0;
+        }
+
+        for (Int_t b = 1; b <= nbins; ++b)
+            toy->SetBinContent(b, counts[b - 1]);
+    }
+
+    toy->ResetStats();
+}
+
+/**
+ * @brief Generates and fits the toys.
+ *
+ * @param ntoys number of toys
+ * @return yields of all toys in toy order; no yields and all toys failed if Minuit2 is not
+ * available
+ */
+ToyResult ToyYields::run(size_t ntoys) const
+{
+    ToyResult result;
+    result.failed = 0;
+    if (!ntoys) return result;
+
+    if (!HasMinimizer("Minuit2"))
+    {
+        Error("ToyYields", "Minuit2 is not available, no toys were fitted");
+        result.failed = ntoys;
+        return result;
+    }
+
+    result.yields.assign(ntoys, std::numeric_limits<double>::quiet_NaN());
+
+    double l = range_l, u = range_u;
+    if (l >= u) total->GetRange(l, u);
+
+    Int_t nbkg = bkg->GetNpar();
+    Int_t offset = bkg_offset >= 0 ? bkg_offset : total->GetNpar() - nbkg;
+
+    // private copies for each chunk of toys, made by this thread
+    size_t nchunks = std::min<size_t>(workers, ntoys);
+    std::vector<TH1*> toys(nchunks);
+    std::vector<TF1*> totals(nchunks), bkgs(nchunks);
+
+    Bool_t add_dir = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(kFALSE);
+    for (size_t c = 0; c < nchunks; ++c)
+    {
+        toys[c] = (TH1*)data->Clone();
+        toys[c]->Sumw2(kFALSE);
+        totals[c] = (TF1*)total->Clone();
+        bkgs[c] = (TF1*)bkg->Clone();
+    }
+    TH1::AddDirectory(add_dir);
+
+    ParallelFor(nchunks, nchunks, [&](size_t c) {
+        TH1* toy = toys[c];
+        TF1* tf = totals[c];
+        TF1* bf = bkgs[c];
+
+        for (size_t i = c * ntoys / nchunks; i < (c + 1) * ntoys / nchunks; ++i)
+        {
+            generate(toy, i);
+
+            // errors too, the minimizer takes its initial steps from them
+            tf->SetParameters(total->GetParameters());
+            tf->SetParErrors(total->GetParErrors());
+            Int_t status = FitWithMinimizer(toy, tf, fit_options, "Minuit2");
+            if (status != 0) continue;
+
+            for (Int_t j = 0; j < nbkg; ++j)
+                bf->SetParameter(j, tf->GetParameter(offset + j));
+
+            result.yields[i] = tf->Integral(l, u) - bf->Integral(l, u);
+        }
+    });
+
+    for (size_t c = 0; c < nchunks; ++c)
+    {
+        delete toys[c];
+        delete totals[c];
+        delete bkgs[c];
+    }
+
+    for (double y : result.yields)
+        if (!std::isfinite(y)) ++result.failed;
+
+    return result;
+}
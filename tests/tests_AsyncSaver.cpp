@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <AsyncSaver.h>
+#include <RootTools.h>
+
+#include <TCanvas.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <TROOT.h>
+#include <TSystem.h>
+
+TEST(tests_AsyncSaver, save_test)
+{
+    gROOT->SetBatch(kTRUE);
+
+    TString fname = TString(gSystem->TempDirectory()) + "/tests_AsyncSaver.root";
+    TString path = TString(gSystem->TempDirectory()) + "/";
+    TFile* f = TFile::Open(fname, "RECREATE");
+
+    RT::Exports::gImgExportPNG = kTRUE;
+    RT::Exports::gImgExportEPS = kFALSE;
+    RT::Exports::gImgExportPDF = kFALSE;
+    for (int i = 0; i < 5; ++i)
+        gSystem->Unlink(path + TString::Format("c_async_%d.png", i));
+
+    {
+        RT::Exports::AsyncSaver saver(2);
+        for (int i = 0; i < 5; ++i)
+        {
+            TCanvas* can = new TCanvas(TString::Format("c_async_%d", i), "c", 200, 200);
+            TH1D* h = new TH1D(TString::Format("h_async_%d", i), "h", 10, 0, 10);
+            h->SetDirectory(nullptr);
+            h->Fill(i);
+            h->Draw();
+            saver.saveAndClose(can, f, i % 2 == 0, path);
+            ASSERT_LE(saver.pending(), 2);
+            ASSERT_TRUE(f->GetKey(TString::Format("c_async_%d", i)));
+        }
+        saver.drain();
+        ASSERT_EQ(saver.pending(), 0);
+        ASSERT_EQ(saver.getFailed(), 0);
+    }
+
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ(gSystem->AccessPathName(path + TString::Format("c_async_%d.png", i)), i % 2 != 0);
+
+    f->Close();
+};
@@ -2,6 +2,11 @@
 
 #include <RootTools.h>
 #include <TH1.h>
+#include <TH2.h>
+#include <TSystem.h>
+
+#include <fstream>
+#include <string>
 
 TEST(tests_Basics, errors_test)
 {
@@ -14,3 +19,122 @@ TEST(tests_Basics, errors_test)
 
     printf(" err1 = %g\t err2 = %g\n", err1, err2);
 };
+
+TEST(tests_Basics, errors_parse_test)
+{
+    auto errs = RT::errorsStrToArray("0.5|+0.3-0.2| -0.1 +0.4||1e-3");
+    ASSERT_EQ(errs.size(), 5);
+    ASSERT_EQ(errs[0].low, 0.5);
+    ASSERT_EQ(errs[0].high, 0.5);
+    ASSERT_EQ(errs[1].high, 0.3);
+    ASSERT_EQ(errs[1].low, 0.2);
+    ASSERT_EQ(errs[2].high, 0.4);
+    ASSERT_EQ(errs[2].low, 0.1);
+    ASSERT_EQ(errs[3].low, 0.0);
+    ASSERT_EQ(errs[4].high, 1e-3);
+
+    std::vector<RT::ErrorsParseIssue> issues;
+    errs = RT::errorsStrToArray("1|+x|2 3", &issues);
+    ASSERT_EQ(errs.size(), 3);
+    ASSERT_EQ(issues.size(), 2);
+    ASSERT_EQ(issues[0].section, 1);
+    ASSERT_EQ(issues[0].position, 3);
+    ASSERT_EQ(issues[1].section, 2);
+    ASSERT_EQ(issues[1].position, 7);
+
+    RT::ErrorsPair buf[2];
+    ASSERT_EQ(RT::errorsStrToArray("1|2|3", buf, 2), 3);
+    ASSERT_EQ(buf[1].high, 2);
+    ASSERT_EQ(RT::errorsStrToArray("4|5|6", 3, buf, 2), 2);
+    ASSERT_EQ(buf[1].low, 5);
+
+    issues.clear();
+    errs = RT::errorsStrToArray("++1|0x1|-2.5e1", &issues);
+    ASSERT_EQ(issues.size(), 2);
+    ASSERT_EQ(issues[0].position, 1);
+    ASSERT_EQ(issues[1].position, 5);
+    ASSERT_EQ(errs[2].low, 25);
+};
+
+TEST(tests_Basics, errors_file_test)
+{
+    TString fname = TString(gSystem->TempDirectory()) + "/tests_Basics_errors.txt";
+
+    // more than two 64 KiB chunks of the file parser, sections straddle the chunk boundaries
+    std::string text;
+    const char* sections[] = {"0.5", "+0.3-0.2", " -0.1 +0.4\n", "", "1e-3", "+x", "2 3"};
+    for (size_t i = 0; text.size() < 65530; ++i)
+        text += std::string(sections[i % 7]) + "|";
+    text.resize(65530, ' ');
+    text += "|1.5e0x|0.25";
+
+    // section longer than a chunk, it is malformed from its first character on
+    text += "|" + std::string(70000, 'x') + "|";
+    for (size_t i = 0; text.size() < 3 * 65536; ++i)
+        text += std::string(sections[i % 7]) + "|";
+    text += "4";
+
+    {
+        std::ofstream ofs(fname.Data(), std::ios::binary | std::ios::trunc);
+        ofs << text;
+    }
+
+    std::vector<RT::ErrorsParseIssue> str_issues;
+    std::vector<RT::ErrorsPair> str_errs = RT::errorsStrToArray(text, &str_issues);
+
+    std::vector<RT::ErrorsParseIssue> file_issues;
+    std::vector<RT::ErrorsPair> file_errs(str_errs.size());
+    ASSERT_EQ(RT::errorsFileToArray(fname, file_errs.data(), file_errs.size(), &file_issues),
+              str_errs.size());
+
+    for (size_t i = 0; i < str_errs.size(); ++i)
+    {
+        ASSERT_EQ(file_errs[i].high, str_errs[i].high) << "section " << i;
+        ASSERT_EQ(file_errs[i].low, str_errs[i].low) << "section " << i;
+    }
+
+    ASSERT_EQ(file_issues.size(), str_issues.size());
+    for (size_t i = 0; i < str_issues.size(); ++i)
+    {
+        ASSERT_EQ(file_issues[i].section, str_issues[i].section);
+        ASSERT_EQ(file_issues[i].position, str_issues[i].position);
+    }
+
+    ASSERT_EQ(RT::errorsFileToArray(fname + "_none", nullptr, 0), (size_t)-1);
+};
+
+TEST(tests_Basics, palettes_test)
+{
+    const Int_t NRGBs = 2;
+    Double_t stops[NRGBs] = {0.00, 1.00};
+    Double_t red[NRGBs] = {0.00, 1.00};
+    Double_t green[NRGBs] = {0.00, 1.00};
+    Double_t blue[NRGBs] = {1.00, 0.00};
+
+    Int_t id1 = RT::Palettes::Create(NRGBs, stops, red, green, blue, 64);
+    Int_t id2 = RT::Palettes::Create(NRGBs, stops, red, green, blue, 64);
+
+    ASSERT_GE(id1, 0);
+    ASSERT_EQ(id1, id2);
+    ASSERT_EQ(RT::Palettes::GetNColors(id1), 64);
+    ASSERT_TRUE(RT::Palettes::Use(id1));
+    ASSERT_FALSE(RT::Palettes::Use(id1 + 1000));
+};
+
+TEST(tests_Basics, no_palette_test)
+{
+    TH2D* h = new TH2D("h_no_palette", "h", 4, 0, 4, 4, 0, 4);
+
+    const char* options[][2] = {{"colz", "col"},           {"COLZ same", "COL same"},
+                                {"cont4z", "cont4"},       {"surf1z fb", "surf1 fb"},
+                                {"col z", "col "},         {"lego2 z same", "lego2  same"},
+                                {"box text", "box text"}};
+    for (const auto& o : options)
+    {
+        h->SetOption(o[0]);
+        RT::NoPalette(h);
+        ASSERT_STREQ(h->GetOption(), o[1]) << o[0];
+    }
+
+    delete h;
+};
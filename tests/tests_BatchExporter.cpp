@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include <BatchExporter.h>
+#include <RootTools.h>
+
+#include <TCanvas.h>
+#include <TH1.h>
+#include <TROOT.h>
+#include <TSystem.h>
+
+TEST(tests_BatchExporter, export_test)
+{
+    gROOT->SetBatch(kTRUE);
+
+    RT::Exports::gImgExportPNG = kTRUE;
+    RT::Exports::gImgExportEPS = kFALSE;
+    RT::Exports::gImgExportPDF = kFALSE;
+
+    TString path = TString(gSystem->TempDirectory()) + "/";
+
+    RT::Exports::BatchExporter exporter(2);
+    for (int i = 0; i < 3; ++i)
+    {
+        TCanvas* can = new TCanvas(TString::Format("c_batch_export_%d", i), "c", 200, 200);
+        TH1D* h = new TH1D(TString::Format("h_batch_export_%d", i), "h", 10, 0, 10);
+        h->Fill(i);
+        h->Draw();
+        exporter.add(can, path);
+        delete can;
+    }
+
+    ASSERT_EQ(exporter.size(), 3);
+
+    auto results = exporter.run();
+    ASSERT_EQ(results.size(), 3);
+    ASSERT_EQ(exporter.size(), 0);
+
+    for (auto& r : results)
+    {
+        ASSERT_TRUE(r.ok) << r.message.Data();
+        ASSERT_FALSE(gSystem->AccessPathName(path + r.name + ".png"));
+    }
+};
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <Columnar.h>
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TSystem.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+TEST(tests_Columnar, roundtrip_test)
+{
+    TString tmp = gSystem->TempDirectory();
+    TString cname = tmp + "/tests_Columnar.rtcol";
+
+    TH1D* h1 = new TH1D("h1_col", "h1;x", 10, 0, 10);
+    h1->Fill(3);
+    h1->Fill(3, 2);
+    TH2F* h2 = new TH2F("h2_col", "h2;x;y", 4, 0, 4, 3, 0, 3);
+    h2->Fill(1.5, 2.5);
+
+    ASSERT_TRUE(RT::WriteColumnar({h1, h2}, cname));
+
+    {
+        RT::ColumnarFile cf(cname);
+        ASSERT_TRUE(cf.isOpen());
+        ASSERT_EQ(cf.size(), 2);
+
+        const RT::HistView* v1 = cf.find("h1_col");
+        ASSERT_NE(v1, nullptr);
+        ASSERT_EQ(v1->GetBinContent(4), 3);
+        ASSERT_EQ(v1->GetBinError(4), h1->GetBinError(4));
+        ASSERT_EQ(cf.find("none"), nullptr);
+
+        TH1* r2 = cf.makeHistogram("h2_col");
+        ASSERT_EQ(r2->GetDimension(), 2);
+        ASSERT_EQ(r2->GetBinContent(2, 3), 1);
+        ASSERT_STREQ(r2->GetTitle(), h2->GetTitle());
+        delete r2;
+    }
+
+    TString fname = tmp + "/tests_Columnar.root";
+    {
+        TFile f(fname, "RECREATE");
+        h1->Write();
+        f.mkdir("sub")->cd();
+        h2->Write();
+        f.Close();
+    }
+
+    TFile f(fname);
+    ASSERT_EQ(RT::WriteColumnar(&f, cname), 2);
+
+    RT::ColumnarFile cf(cname);
+    ASSERT_NE(cf.find("sub/h2_col"), nullptr);
+
+    std::vector<TH1*> hists = cf.makeHistograms();
+    ASSERT_EQ(hists.size(), 2);
+    for (auto h : hists)
+        delete h;
+
+    delete h1;
+    delete h2;
+};
+
+TEST(tests_Columnar, corrupt_test)
+{
+    TString cname = TString(gSystem->TempDirectory()) + "/tests_Columnar_corrupt.rtcol";
+
+    TH1D* h = new TH1D("h_col_corrupt", "h;x", 10, 0, 10);
+    h->Fill(3);
+    ASSERT_TRUE(RT::WriteColumnar({h}, cname));
+    delete h;
+
+    std::string good;
+    {
+        std::ifstream ifs(cname.Data(), std::ios::binary);
+        good.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    auto write_file = [&](const std::string& bytes) {
+        std::ofstream ofs(cname.Data(), std::ios::binary | std::ios::trunc);
+        ofs.write(bytes.data(), bytes.size());
+    };
+
+    // more histograms (after the 8 byte magic) than the index holds
+    std::string bad = good;
+    ULong64_t nhists = 1000;
+    memcpy(&bad[8], &nhists, sizeof(nhists));
+    write_file(bad);
+    ASSERT_FALSE(RT::ColumnarFile(cname).isOpen());
+
+    // cells offset of the first record (last field of the record at byte 80) out of the arrays
+    bad = good;
+    ULong64_t cells = 1000;
+    memcpy(&bad[80 + 80], &cells, sizeof(cells));
+    write_file(bad);
+    ASSERT_FALSE(RT::ColumnarFile(cname).isOpen());
+
+    write_file(good);
+    ASSERT_TRUE(RT::ColumnarFile(cname).isOpen());
+};
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <CompactHist.h>
+#include <RootTools.h>
+
+#include <TH3.h>
+
+#include <cmath>
+
+TEST(tests_CompactHist, precision_test)
+{
+    TH3D* h = new TH3D("h_compact", "h", 40, 0, 40, 40, 0, 40, 40, 0, 40);
+    for (int i = 0; i < 2000; ++i)
+        h->Fill(i % 40 + 0.5, (i / 40) % 10 + 0.5, 5.5, 1.0 + i % 7);
+
+    RT::CompactHist cf(h, RT::CP_FLOAT);
+    RT::CompactHist cq(h, RT::CP_BLOCK16);
+
+    size_t full = 2 * h->GetNcells() * sizeof(Double_t);
+    ASSERT_LT(cf.getMemory(), full / 2 + 1);
+    ASSERT_LT(cq.getMemory(), full / 4);
+
+    for (Int_t bin = 0; bin < h->GetNcells(); ++bin)
+    {
+        ASSERT_NEAR(cf.GetBinContent(bin), h->GetBinContent(bin), 1e-7 * 400);
+        ASSERT_NEAR(cq.GetBinContent(bin), h->GetBinContent(bin), 400.0 / 65534);
+        ASSERT_NEAR(cq.GetBinError(bin), h->GetBinError(bin), 400.0 / 65534);
+    }
+
+    double c, e, cc, ce;
+    RT::calcTotalHistogramValues(cq, cc, ce);
+    ASSERT_NEAR(cc, h->Integral(), 1e-3 * h->Integral());
+
+    TH1* r = cf.makeHistogram();
+    ASSERT_EQ(r->GetDimension(), 3);
+    ASSERT_EQ(r->GetNcells(), h->GetNcells());
+    ASSERT_FLOAT_EQ(r->GetBinContent(1, 1, 6), h->GetBinContent(1, 1, 6));
+    ASSERT_FLOAT_EQ(r->GetBinError(1, 1, 6), h->GetBinError(1, 1, 6));
+    delete r;
+
+    c = RT::calcTotalContent(cf);
+    e = RT::calcTotalError(cf);
+    ASSERT_FLOAT_EQ(c, h->Integral());
+    ASSERT_GT(e, 0);
+
+    delete h;
+};
+
+TEST(tests_CompactHist, error_propagation_test)
+{
+    TH2D* h = new TH2D("h_compact2", "h", 20, 0, 20, 20, 0, 20);
+    h->Sumw2();
+    for (int i = 0; i < 400; ++i)
+        h->Fill(i % 20 + 0.5, i / 20 + 0.5, 2);
+
+    RT::CompactHist ch(h);
+    RT::calcErrorPropagationMult(h, 2, 0.1);
+    RT::calcErrorPropagationMult(ch, 2, 0.1);
+
+    for (Int_t bin = 0; bin < h->GetNcells(); ++bin)
+        ASSERT_FLOAT_EQ(ch.GetBinError(bin), h->GetBinError(bin));
+
+    // out of range bins are empty, as in TH1
+    ASSERT_EQ(ch.GetBinContent(-1), 0);
+    ASSERT_EQ(ch.GetBinError(h->GetNcells()), 0);
+    ASSERT_EQ(ch.GetBinContent(100 * h->GetNcells()), 0);
+
+    delete h;
+};
+
+TEST(tests_CompactHist, error_propagation_3d_test)
+{
+    TH3D* h = new TH3D("h_compact3", "h", 4, 0, 4, 4, 0, 4, 4, 0, 4);
+    h->Sumw2();
+    h->Fill(1.5, 1.5, 2.5, 4);
+    h->Fill(2.5, 0.5, 0.5, 2);
+
+    // every in-range bin of the 3D histogram is propagated
+    RT::CompactHist ch(h);
+    RT::calcErrorPropagationDiv(ch, 2, 0.2);
+
+    for (Int_t bin = 0; bin < h->GetNcells(); ++bin)
+    {
+        Int_t x, y, z;
+        h->GetBinXYZ(bin, x, y, z);
+        bool in_range = x >= 1 and x <= 4 and y >= 1 and y <= 4 and z >= 1 and z <= 4;
+
+        double c = h->GetBinContent(bin);
+        double e = h->GetBinError(bin);
+        double expected = in_range ? sqrt(4 * e * e * 4 + 4 * c * c * 0.04) / 4 : e;
+        ASSERT_FLOAT_EQ(ch.GetBinError(bin), expected);
+    }
+
+    delete h;
+};
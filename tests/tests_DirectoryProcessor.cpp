@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <DirectoryProcessor.h>
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TNamed.h>
+#include <TSystem.h>
+
+TEST(tests_DirectoryProcessor, run_test)
+{
+    TString tmp = gSystem->TempDirectory();
+    TString sname = tmp + "/tests_DirectoryProcessor_src.root";
+    TString tname = tmp + "/tests_DirectoryProcessor_dst.root";
+
+    {
+        TFile f(sname, "RECREATE");
+        TH1D h1("h1_dp", "h1", 10, 0, 10);
+        h1.Fill(3, 4);
+        h1.Write();
+        TNamed n("note", "not a histogram");
+        n.Write();
+        f.mkdir("sub")->cd();
+        TH2D h2("h2_dp", "h2", 4, 0, 4, 3, 0, 3);
+        h2.Fill(1.5, 2.5, 4);
+        h2.Write();
+        f.Close();
+    }
+
+    TFile src(sname);
+    TFile dst(tname, "RECREATE");
+
+    RT::DirectoryProcessor proc(2);
+    auto mult = RT::DirectoryProcessor::ErrorPropagationMult(2, 0);
+    RT::ProcessSummary s = proc.run(&src, &dst, mult);
+    ASSERT_EQ(s.visited, 3);
+    ASSERT_EQ(s.matched, 2);
+    ASSERT_EQ(s.processed, 2);
+    ASSERT_EQ(s.failed, 0);
+
+    // only the errors change, with err = 0 they stay the input ones
+    TH1* r1 = dynamic_cast<TH1*>(dst.Get("h1_dp"));
+    ASSERT_NE(r1, nullptr);
+    ASSERT_EQ(r1->GetBinContent(4), 4);
+    ASSERT_DOUBLE_EQ(r1->GetBinError(4), 4);
+    TH1* r2 = dynamic_cast<TH1*>(dst.Get("sub/h2_dp"));
+    ASSERT_NE(r2, nullptr);
+    ASSERT_EQ(r2->GetBinContent(2, 3), 4);
+    ASSERT_DOUBLE_EQ(r2->GetBinError(2, 3), 4);
+
+    proc.setPattern("sub/*");
+    s = proc.run(&src, &dst, RT::DirectoryProcessor::RelativeErrorHistogram());
+    ASSERT_EQ(s.matched, 1);
+    ASSERT_EQ(s.processed, 1);
+    // Get() would return r2 from the memory of the directory, read the new cycle of the key
+    TH1* rel = (TH1*)dst.GetDirectory("sub")->GetKey("h2_dp")->ReadObj();
+    ASSERT_NE(rel, r2);
+    ASSERT_DOUBLE_EQ(rel->GetBinContent(2, 3), 1);
+    delete rel;
+
+    proc.setPattern("");
+    s = proc.run(&src, &dst, [](TH1*, const TString&) -> TH1* { return nullptr; });
+    ASSERT_EQ(s.failed, 2);
+    ASSERT_EQ(s.errors.size(), 2);
+};
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include <Efficiency.h>
+
+#include <TH1.h>
+
+TEST(tests_Efficiency, intervals_test)
+{
+    Double_t pass[3] = {5, 0, 10};
+    Double_t total[3] = {10, 0, 10};
+    Double_t eff[3], lo[3], hi[3];
+
+    RT::CalcEfficiency(pass, total, 3, eff, lo, hi, RT::EI_NORMAL);
+    ASSERT_DOUBLE_EQ(eff[0], 0.5);
+    ASSERT_NEAR(lo[0], sqrt(0.025), 1e-6);
+    ASSERT_EQ(eff[1], 0);
+    ASSERT_EQ(hi[1], 0);
+    ASSERT_EQ(hi[2], 0);
+
+    RT::CalcEfficiency(pass, total, 3, eff, lo, hi, RT::EI_WILSON);
+    ASSERT_NEAR(lo[0], hi[0], 1e-9);
+    ASSERT_EQ(hi[1], 1);
+    ASSERT_NEAR(hi[2], 0, 1e-9);
+    ASSERT_GT(lo[2], 0);
+
+    RT::CalcEfficiency(pass, total, 3, eff, lo, hi, RT::EI_CLOPPER_PEARSON);
+    ASSERT_GT(lo[0], 0);
+    ASSERT_EQ(hi[1], 1);
+
+    TH1D* hp = new TH1D("h_eff_pass", "h", 100000, 0, 1);
+    TH1D* ht = new TH1D("h_eff_total", "h", 100000, 0, 1);
+    TH1D* he = new TH1D("h_eff", "h", 100000, 0, 1);
+    for (int i = 1; i <= 100000; ++i)
+    {
+        ht->SetBinContent(i, 4);
+        hp->SetBinContent(i, i % 5);
+    }
+
+    std::vector<RT::ErrorsPair> errors;
+    ASSERT_TRUE(RT::CalcEfficiency(hp, ht, he, RT::EI_WILSON, 0.68, 4, &errors));
+    ASSERT_DOUBLE_EQ(he->GetBinContent(3), 0.75);
+    ASSERT_EQ(errors.size(), he->GetNcells());
+    ASSERT_EQ(he->GetBinContent(0), 0);
+
+    delete hp;
+    delete ht;
+    delete he;
+};
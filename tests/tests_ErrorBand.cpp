@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <ErrorBand.h>
+#include <RootTools.h>
+
+#include <TF1.h>
+
+TEST(tests_ErrorBand, band_test)
+{
+    TF1* f = new TF1("f_band", "pol1", 0, 10);
+    f->SetParameter(0, 2);
+    f->SetParameter(1, 3);
+
+    TMatrixDSym cov(2);
+    cov(0, 0) = 0.04;
+    cov(1, 1) = 0.01;
+    cov(0, 1) = cov(1, 0) = -0.015;
+
+    RT::ErrorBand eb(f, cov);
+
+    Double_t x[3] = {0, 1, 4};
+    Double_t val[3], err[3];
+    eb.band(x, 3, val, err);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_NEAR(val[i], 2 + 3 * x[i], 1e-9);
+        double var = 0.04 - 2 * 0.015 * x[i] + 0.01 * x[i] * x[i];
+        ASSERT_NEAR(err[i], sqrt(var), 1e-6);
+    }
+
+    auto in = eb.integral(0, 2);
+    ASSERT_NEAR(in.first, 10, 1e-9);
+    ASSERT_NEAR(in.second, sqrt(4 * 0.04 - 8 * 0.015 + 4 * 0.01), 1e-6);
+
+    // parameters are not modified
+    ASSERT_EQ(f->GetParameter(0), 2);
+
+    // without correlations, from the parameter errors
+    f->SetParError(0, 0.2);
+    f->SetParError(1, 0.1);
+    eb.setCovariance();
+    eb.band(x, 3, val, err);
+    ASSERT_NEAR(err[2], sqrt(0.04 + 0.16), 1e-6);
+
+    delete f;
+};
+
+TEST(tests_ErrorBand, func_error_bar_test)
+{
+    TF1* f = new TF1("f_bar", "pol1", 0, 10);
+    f->SetParameter(0, 2);
+    f->SetParameter(1, 3);
+    f->SetParError(0, 0.2);
+    f->SetParError(1, 0.1);
+
+    // (2 * 0.2 + 2 * 0.1) * 2
+    ASSERT_NEAR(RT::calcFuncErrorBar(f, 0, 2), 1.2, 1e-9);
+    ASSERT_EQ(f->GetParameter(0), 2);
+    ASSERT_EQ(f->GetParameter(1), 3);
+
+    delete f;
+};
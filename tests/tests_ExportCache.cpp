@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <ExportCache.h>
+#include <RootTools.h>
+
+#include <TCanvas.h>
+#include <TH1.h>
+#include <TROOT.h>
+#include <TSystem.h>
+
+TEST(tests_ExportCache, skip_test)
+{
+    gROOT->SetBatch(kTRUE);
+
+    RT::Exports::gImgExportPNG = kTRUE;
+    RT::Exports::gImgExportEPS = kFALSE;
+    RT::Exports::gImgExportPDF = kFALSE;
+
+    TString path = TString(gSystem->TempDirectory()) + "/";
+    gSystem->Unlink(path + RT::Exports::ExportCache::manifest_name);
+
+    TCanvas* can = new TCanvas("c_export_cache", "c", 200, 200);
+    TH1D* h = new TH1D("h_export_cache", "h", 10, 0, 10);
+    h->Fill(1);
+    h->Draw();
+
+    {
+        RT::Exports::ExportCache cache(path);
+        ASSERT_TRUE(cache.exportImages(can));
+        ASSERT_FALSE(cache.exportImages(can));
+    }
+
+    {
+        RT::Exports::ExportCache cache(path);
+        ASSERT_FALSE(cache.exportImages(can));
+
+        h->Fill(2);
+        ASSERT_TRUE(cache.exportImages(can));
+        ASSERT_EQ(cache.getExported(), 1);
+        ASSERT_EQ(cache.getSkipped(), 1);
+    }
+
+    // names with spaces survive the manifest
+    TCanvas* cs = new TCanvas("c export cache", "c", 200, 200);
+    h->Draw();
+    {
+        RT::Exports::ExportCache cache(path);
+        ASSERT_TRUE(cache.exportImages(cs));
+    }
+    {
+        RT::Exports::ExportCache cache(path);
+        ASSERT_FALSE(cache.exportImages(cs));
+        ASSERT_FALSE(cache.exportImages(can));
+    }
+
+    delete cs;
+    delete can;
+};
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <FileAccessor.h>
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TSystem.h>
+
+TEST(tests_FileAccessor, get_test)
+{
+    TString fname = TString(gSystem->TempDirectory()) + "/tests_FileAccessor.root";
+
+    {
+        TFile f(fname, "RECREATE");
+        for (int i = 0; i < 10; ++i)
+        {
+            TH1D h(TString::Format("h_%d", i), "h", 100, 0, 100);
+            h.Fill(i);
+            h.Write();
+        }
+        TDirectory* dir = f.mkdir("sub");
+        dir->cd();
+        TH1D h("h_sub", "h", 100, 0, 100);
+        h.Write();
+        f.Close();
+    }
+
+    RT::FileAccessor acc(fname);
+    ASSERT_TRUE(acc.isOpen());
+    ASSERT_EQ(acc.getKeys(), 11);
+    ASSERT_TRUE(acc.has("sub/h_sub"));
+
+    TH1* h = acc.get<TH1>("h_3");
+    ASSERT_NE(h, nullptr);
+    ASSERT_EQ(h->GetBinContent(4), 1);
+    ASSERT_EQ(acc.get("h_missing"), nullptr);
+
+    std::vector<TString> names = {"h_9", "h_1", "h_3", "sub/h_sub", "h_none"};
+    std::vector<TObject*> objs;
+    ASSERT_EQ(acc.get(names, objs), 1);
+    ASSERT_EQ(objs.size(), 5);
+    ASSERT_EQ(objs[2], h);
+    ASSERT_EQ(objs[4], nullptr);
+    ASSERT_EQ(acc.getHits(), 1);
+    ASSERT_EQ(acc.getReads(), 4);
+    ASSERT_EQ(acc.getRequests(), 2);
+
+    acc.setBudget(0);
+    ASSERT_EQ(acc.getMemory(), 0);
+    ASSERT_NE(acc.get("h_3"), nullptr);
+};
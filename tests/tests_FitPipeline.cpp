@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <FitPipeline.h>
+#include <RootTools.h>
+
+#include <TF1.h>
+#include <TH1.h>
+
+#include <cmath>
+
+TEST(tests_FitPipeline, slices_test)
+{
+    TF1* model = new TF1("f_pipe_model", "gaus(0)+pol0(3)", 0, 10);
+    model->SetParameters(std::vector<Double_t>({100, 5, 0.5, 10}).data());
+
+    std::vector<TH1*> hists;
+    for (int ix = 0; ix < 3; ++ix)
+        for (int iy = 0; iy < 2; ++iy)
+        {
+            TH1D* h = new TH1D(TString::Format("h_pipe_%d_%d", ix, iy), "h", 100, 0, 10);
+            h->SetDirectory(nullptr);
+            double mean = 4.5 + 0.3 * ix + 0.2 * iy;
+            double amplitude = 100 + 50 * ix + 10 * iy; // distinct, the largest slice is unique
+            for (Int_t b = 1; b <= 100; ++b)
+            {
+                double x = h->GetBinCenter(b);
+                h->SetBinContent(b, amplitude * exp(-0.5 * pow((x - mean) / 0.4, 2)) + 5);
+                h->SetBinError(b, 1);
+            }
+            hists.push_back(h);
+        }
+
+    auto run = [&](UInt_t workers, std::vector<double>& means) {
+        RT::FitPipeline fp(model, workers);
+        for (int ix = 0; ix < 3; ++ix)
+            for (int iy = 0; iy < 2; ++iy)
+                fp.addSlice(hists[ix * 2 + iy], ix, iy);
+
+        size_t converged = fp.run();
+        means.clear();
+        for (size_t i = 0; i < fp.size(); ++i)
+            means.push_back(fp.getSlice(i).params[1]);
+
+        // largest slice first, the rest started from neighbours
+        EXPECT_EQ(fp.getSlice(5).seed, -1);
+        EXPECT_GE(fp.getSlice(0).seed, 0);
+        EXPECT_GT(fp.getWaves(), 1);
+        return converged;
+    };
+
+    std::vector<double> m1, m4;
+    ASSERT_EQ(run(1, m1), 6);
+    ASSERT_EQ(run(4, m4), 6);
+    for (size_t i = 0; i < m1.size(); ++i)
+    {
+        ASSERT_DOUBLE_EQ(m1[i], m4[i]);
+        ASSERT_NEAR(m1[i], 4.5 + 0.3 * (i / 2) + 0.2 * (i % 2), 1e-3);
+    }
+
+    for (auto h : hists)
+        delete h;
+    delete model;
+};
+
+TEST(tests_FitPipeline, fit_info_test)
+{
+    TF1* f = new TF1("f_pipe_voigt", "[0] * TMath::Voigt(x - [1], [2], [3], 4)", 0, 2);
+    f->SetTitle("voigt");
+    f->SetParameters(std::vector<Double_t>({1, 1.115, 0.002, 0.001}).data());
+
+    double mean = 0, width = 0;
+    ASSERT_TRUE(RT::calcFitInfo(f, mean, width));
+    ASSERT_DOUBLE_EQ(mean, 1.115);
+    ASSERT_DOUBLE_EQ(width, 0.5346 * 0.002 + sqrt(0.2166 * 0.002 * 0.002 + 0.001 * 0.001));
+
+    f->SetTitle("unknown");
+    ASSERT_FALSE(RT::calcFitInfo(f, mean, width));
+
+    delete f;
+};
+
+TEST(tests_FitPipeline, signal_test)
+{
+    TF1* model = new TF1("f_pipe_sb", "[0] * TMath::Voigt(x - [1], [2], [3], 4) + [4]", 1, 1.25);
+    TF1* sig = new TF1("f_pipe_sig", "[0] * TMath::Voigt(x - [1], [2], [3], 4)", 1, 1.25);
+    sig->SetTitle("voigt");
+
+    std::vector<TH1*> hists;
+    for (int ix = 0; ix < 2; ++ix)
+    {
+        TH1D* h = new TH1D(TString::Format("h_pipe_sb_%d", ix), "h", 100, 1, 1.25);
+        h->SetDirectory(nullptr);
+        double mean = 1.115 + 0.005 * ix;
+        model->SetParameters(std::vector<Double_t>({10, mean, 0.003, 0.004, 5}).data());
+        for (Int_t b = 1; b <= 100; ++b)
+        {
+            h->SetBinContent(b, model->Eval(h->GetBinCenter(b)));
+            h->SetBinError(b, 1);
+        }
+        hists.push_back(h);
+    }
+    model->SetParameters(std::vector<Double_t>({8, 1.11, 0.004, 0.003, 4}).data());
+
+    RT::FitPipeline fp(model, 2);
+    fp.addSlice(hists[0], 0);
+    fp.addSlice(hists[1], 1);
+
+    // the model has no parameters 5 and 6
+    ASSERT_FALSE(fp.setSignal(sig, 2));
+    ASSERT_TRUE(fp.setSignal(sig, 0));
+
+    ASSERT_EQ(fp.run(), 2);
+    for (size_t i = 0; i < fp.size(); ++i)
+    {
+        const RT::SliceFit& s = fp.getSlice(i);
+        ASSERT_TRUE(s.has_info);
+        ASSERT_NEAR(s.mean, 1.115 + 0.005 * i, 1e-5);
+        ASSERT_NEAR(s.width, 0.5346 * 0.003 + sqrt(0.2166 * 0.003 * 0.003 + 0.004 * 0.004), 1e-4);
+    }
+
+    for (auto h : hists)
+        delete h;
+    delete sig;
+    delete model;
+};
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <GraphDecimation.h>
+#include <RootTools.h>
+
+#include <TGraph.h>
+#include <TGraphErrors.h>
+#include <TMath.h>
+
+TEST(tests_GraphDecimation, decimation_test)
+{
+    const int n = 100000;
+    TGraphErrors* gr = new TGraphErrors(n);
+    for (int i = 0; i < n; ++i)
+    {
+        gr->SetPoint(i, i, TMath::Sin(i * 0.001));
+        gr->SetPointError(i, 0, 0.01);
+    }
+    gr->SetPoint(31415, 31415, 5.0);
+
+    // extremes of y and of y with errors are different points in the same column
+    gr->SetPoint(31416, 31416, 4.9);
+    gr->SetPointError(31416, 0, 1.0);
+    gr->SetPoint(12345, 12345, -5.0);
+    gr->SetPoint(12346, 12346, -4.9);
+    gr->SetPointError(12346, 0, 1.0);
+    gr->SetPoint(27182, 27182, 4.0);
+    gr->SetPointError(27182, 0, 3.0);
+
+    double min_ref, max_ref;
+    RT::FindBoundaries(gr, min_ref, max_ref);
+
+    for (auto mode : {RT::DM_MINMAX, RT::DM_LTTB})
+    {
+        TGraph* dec = RT::DecimateGraph(gr, 500, mode);
+        ASSERT_TRUE(dec->InheritsFrom(TGraphErrors::Class()));
+        ASSERT_LE(dec->GetN(), 6 * 500 + 4);
+
+        double min, max;
+        RT::FindBoundaries(dec, min, max);
+        ASSERT_DOUBLE_EQ(min, min_ref);
+        ASSERT_DOUBLE_EQ(max, max_ref);
+
+        delete dec;
+    }
+
+    delete gr;
+};
+
+TEST(tests_GraphDecimation, logx_test)
+{
+    const int n = 10000;
+    TGraph* gr = new TGraph(n);
+    for (int i = 0; i < n; ++i)
+        gr->SetPoint(i, i - 10, TMath::Sin(i * 0.01));
+
+    for (auto mode : {RT::DM_MINMAX, RT::DM_LTTB})
+    {
+        TGraph* dec = RT::DecimateGraph(gr, 100, mode, kTRUE);
+        ASSERT_LE(dec->GetN(), 6 * 100 + 4 + 11);
+
+        // points at x <= 0 can't be placed in log x and are kept
+        for (int i = 0; i <= 10; ++i)
+            ASSERT_EQ(dec->GetX()[i], i - 10);
+        ASSERT_EQ(dec->GetX()[dec->GetN() - 1], n - 11);
+
+        delete dec;
+    }
+
+    delete gr;
+};
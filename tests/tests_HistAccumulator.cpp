@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <HistAccumulator.h>
+#include <Parallel.h>
+
+#include <TH1.h>
+#include <TH2.h>
+
+TEST(tests_HistAccumulator, fill_test)
+{
+    TH1D model("h_acc", "h_acc", 10, 0, 10);
+
+    RT::HistAccumulator acc(&model, 4);
+    ASSERT_EQ(acc.getSlots(), 4);
+
+    RT::ParallelFor(4, 4, [&](size_t) {
+        UInt_t slot = acc.acquire();
+        for (int i = 0; i < 1000; ++i)
+            acc.fill(slot, i % 10 + 0.5);
+    });
+    ASSERT_EQ(acc.acquire(), 4);
+
+    TH1* h = acc.merge();
+    ASSERT_EQ(h->GetBinContent(1), 400);
+    ASSERT_EQ(h->GetEntries(), 4000);
+    ASSERT_EQ(acc.local(0)->GetEntries(), 0);
+    ASSERT_EQ(acc.acquire(), 0);
+    delete h;
+};
+
+TEST(tests_HistAccumulator, buffered_test)
+{
+    TH2D model("h2_acc", "h2_acc", 4, 0, 4, 4, 0, 4);
+
+    RT::HistAccumulator acc(&model, 3, 64);
+
+    RT::ParallelFor(3, 3, [&](size_t) {
+        UInt_t slot = acc.acquire();
+        for (int i = 0; i < 1000; ++i)
+            acc.fillXY(slot, i % 4 + 0.5, 1.5, 2);
+    });
+
+    TH1* h = acc.merge();
+    ASSERT_EQ(h->GetBinContent(1, 2), 1500);
+    ASSERT_EQ(h->GetBinContent(1, 1), 0);
+    ASSERT_EQ(h->GetEntries(), 3000);
+    delete h;
+};
+
+TEST(tests_HistAccumulator, overflow_test)
+{
+    TH1D model("h_acc_over", "h_acc_over", 10, 0, 10);
+
+    RT::HistAccumulator acc(&model, 2, 16);
+
+    // more threads than slots, the extra ones share the overflow slot
+    RT::ParallelFor(6, 6, [&](size_t) {
+        UInt_t slot = acc.acquire();
+        ASSERT_LE(slot, acc.getSlots());
+        for (int i = 0; i < 1000; ++i)
+            acc.fill(slot, i % 10 + 0.5);
+    });
+    ASSERT_NE(acc.local(acc.getSlots()), nullptr);
+
+    TH1* h = acc.merge();
+    ASSERT_EQ(h->GetBinContent(1), 600);
+    ASSERT_EQ(h->GetEntries(), 6000);
+    ASSERT_EQ(acc.local(acc.getSlots())->GetEntries(), 0);
+    delete h;
+};
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <HistCache.h>
+#include <RootTools.h>
+
+#include <TFile.h>
+#include <TH2.h>
+#include <TSystem.h>
+
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+
+TEST(tests_HistCache, cache_test)
+{
+    TString tmp = gSystem->TempDirectory();
+    TString fname = tmp + "/tests_HistCache.root";
+    TString cname = tmp + "/tests_HistCache.rthc";
+
+    Double_t xbins[4] = {0, 1, 5, 10};
+    TH2D* h = new TH2D("h_cache", "h;x;y", 3, xbins, 4, 0, 4);
+    h->Sumw2();
+    h->Fill(0.5, 0.5);
+    h->Fill(2, 1.5, 3);
+    h->Fill(7, 3.5);
+
+    ASSERT_TRUE(RT::HistCache::write(h, cname));
+
+    RT::HistCache cache(cname);
+    ASSERT_TRUE(cache.isValid());
+
+    const RT::HistView& v = cache.view();
+    ASSERT_EQ(v.dim, 2);
+    ASSERT_EQ(v.GetNbinsX(), 3);
+    ASSERT_EQ(v.GetNcells(), h->GetNcells());
+    ASSERT_EQ(v.GetBinContent(2, 2), 3);
+    ASSERT_EQ(v.GetBinError(2, 2), h->GetBinError(2, 2));
+    ASSERT_EQ(RT::calcTotalContent(v), RT::calcTotalContent(h));
+
+    TH1* hc = cache.makeHistogram();
+    ASSERT_STREQ(hc->GetName(), "h_cache");
+    ASSERT_EQ(hc->GetXaxis()->GetBinUpEdge(2), 5);
+    ASSERT_EQ(hc->GetBinContent(3, 4), 1);
+    ASSERT_EQ(hc->GetEntries(), 3);
+    delete hc;
+
+    // a cache older than its source is not used
+    TH1* hs = (TH1*)h->Clone("h_cache");
+    hs->Fill(7, 3.5);
+    TH1D* ho = new TH1D("h_other", "h", 4, 0, 4);
+    ho->Fill(1);
+    {
+        TFile f(fname, "RECREATE");
+        hs->Write();
+        ho->Write();
+    }
+
+    Long_t now = time(nullptr);
+    gSystem->Utime(cname, now - 20, now - 20);
+    gSystem->Utime(fname, now - 10, now - 10);
+    ASSERT_FALSE(RT::HistCache(cname, fname).isValid());
+    // written in the same second is valid
+    gSystem->Utime(cname, now - 10, now - 10);
+    ASSERT_TRUE(RT::HistCache(cname, fname).isValid());
+    gSystem->Utime(cname, now - 20, now - 20);
+
+    TFile f(fname);
+    TH1* hf = RT::HistCache::fetch(&f, "h_cache", cname);
+    ASSERT_NE(hf, nullptr);
+    ASSERT_EQ(hf->GetBinContent(3, 4), 2);
+
+    // the refreshed cache is used
+    {
+        RT::HistCache fresh(cname, fname);
+        ASSERT_TRUE(fresh.isValid());
+        ASSERT_EQ(fresh.view().GetBinContent(3, 4), 2);
+    }
+    TH1* hc2 = RT::HistCache::fetch(&f, "h_cache", cname);
+    ASSERT_EQ(hc2->GetBinContent(3, 4), 2);
+
+    // a cache of another histogram is not used
+    TH1* hother = RT::HistCache::fetch(&f, "h_other", cname);
+    ASSERT_NE(hother, nullptr);
+    ASSERT_STREQ(hother->GetName(), "h_other");
+    ASSERT_EQ(hother->GetBinContent(2), 1);
+
+    ASSERT_EQ(RT::HistCache::fetch(&f, "h_none", cname + "_none"), nullptr);
+
+    delete hother;
+    delete hc2;
+    delete hf;
+    delete ho;
+    delete hs;
+    delete h;
+};
+
+TEST(tests_HistCache, cache_1d_test)
+{
+    TString cname = TString(gSystem->TempDirectory()) + "/tests_HistCache_1d.rthc";
+
+    TH1D* h = new TH1D("h_cache_1d", "h;x", 5, 0, 5);
+    h->Sumw2();
+    h->Fill(-1);
+    h->Fill(2.5, 2);
+    h->Fill(9);
+
+    ASSERT_TRUE(RT::HistCache::write(h, cname));
+
+    RT::HistCache cache(cname);
+    ASSERT_TRUE(cache.isValid());
+
+    const RT::HistView& v = cache.view();
+    ASSERT_EQ(v.dim, 1);
+    ASSERT_EQ(v.GetNcells(), h->GetNcells());
+    ASSERT_EQ(v.GetBin(3), h->GetBin(3));
+    ASSERT_EQ(v.GetBinContent(0), 1);
+    ASSERT_EQ(v.GetBinContent(3), 2);
+    ASSERT_EQ(v.GetBinContent(6), 1);
+
+    TH1* hc = cache.makeHistogram();
+    ASSERT_EQ(hc->GetDimension(), 1);
+    ASSERT_EQ(hc->GetNcells(), h->GetNcells());
+    for (Int_t i = 0; i < h->GetNcells(); ++i)
+    {
+        ASSERT_EQ(hc->GetBinContent(i), h->GetBinContent(i));
+        ASSERT_EQ(hc->GetBinError(i), h->GetBinError(i));
+    }
+
+    delete hc;
+    delete h;
+};
+
+TEST(tests_HistCache, corrupt_test)
+{
+    TString cname = TString(gSystem->TempDirectory()) + "/tests_HistCache_corrupt.rthc";
+
+    TH1D* h = new TH1D("h_cache_corrupt", "h;x", 5, 0, 5);
+    h->Fill(2.5);
+    ASSERT_TRUE(RT::HistCache::write(h, cname));
+    delete h;
+
+    std::string good;
+    {
+        std::ifstream ifs(cname.Data(), std::ios::binary);
+        good.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+    auto write_file = [&](const std::string& bytes) {
+        std::ofstream ofs(cname.Data(), std::ios::binary | std::ios::trunc);
+        ofs.write(bytes.data(), bytes.size());
+    };
+
+    // x bins (after the 8 byte magic and the dimension) larger than the file
+    std::string bad = good;
+    Int_t nbins = 1000;
+    memcpy(&bad[12], &nbins, sizeof(nbins));
+    write_file(bad);
+    ASSERT_FALSE(RT::HistCache(cname).isValid());
+
+    // name and everything after the header without a terminating NUL
+    bad = good;
+    for (size_t i = 112; i < bad.size(); ++i)
+        bad[i] = 'x';
+    write_file(bad);
+    ASSERT_FALSE(RT::HistCache(cname).isValid());
+
+    write_file(good);
+    ASSERT_TRUE(RT::HistCache(cname).isValid());
+};
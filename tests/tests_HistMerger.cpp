@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <HistMerger.h>
+
+#include <TFile.h>
+#include <TH1.h>
+#include <TSystem.h>
+
+TEST(tests_HistMerger, merge_test)
+{
+    TString tmp = gSystem->TempDirectory();
+
+    RT::HistMerger merger(3);
+    // budget for a single key, each key is merged in its own chunk with the same open inputs
+    RT::HistMerger chunked(3, 1);
+    for (int i = 0; i < 7; ++i)
+    {
+        TString fname = tmp + TString::Format("/tests_HistMerger_%d.root", i);
+        TFile f(fname, "RECREATE");
+        TH1D h1("h1", "h", 10, 0, 10);
+        h1.Fill(i);
+        h1.Write();
+        TDirectory* dir = f.mkdir("sub");
+        dir->cd();
+        TH1D h2("h2", "h", 10, 0, 10);
+        h2.Fill(1, 2);
+        h2.Write();
+        f.Close();
+
+        merger.add(fname);
+        chunked.add(fname);
+    }
+
+    TString output = tmp + "/tests_HistMerger.root";
+    ASSERT_EQ(merger.merge(output), 2);
+    ASSERT_EQ(merger.getMissing(), 0);
+    ASSERT_EQ(merger.getFailed(), 0);
+
+    TFile f(output);
+    TH1* h1 = dynamic_cast<TH1*>(f.Get("h1"));
+    TH1* h2 = dynamic_cast<TH1*>(f.Get("sub/h2"));
+    ASSERT_NE(h1, nullptr);
+    ASSERT_NE(h2, nullptr);
+    ASSERT_EQ(h1->GetEntries(), 7);
+    ASSERT_EQ(h1->GetBinContent(4), 1);
+    ASSERT_EQ(h2->GetBinContent(2), 14);
+
+    TString output_chunked = tmp + "/tests_HistMerger_chunked.root";
+    ASSERT_EQ(chunked.merge(output_chunked), 2);
+    ASSERT_EQ(chunked.getMissing(), 0);
+
+    TFile fc(output_chunked);
+    ASSERT_EQ(dynamic_cast<TH1*>(fc.Get("h1"))->GetEntries(), 7);
+    ASSERT_EQ(dynamic_cast<TH1*>(fc.Get("sub/h2"))->GetBinContent(2), 14);
+};
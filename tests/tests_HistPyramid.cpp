@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <HistPyramid.h>
+
+#include <TH2.h>
+
+TEST(tests_HistPyramid, levels_test)
+{
+    TH2D* h = new TH2D("h_pyramid", "h", 100, 0, 1, 100, 0, 1);
+    for (int i = 0; i < 1000; ++i)
+        h->Fill(i / 1000., (i % 100) / 100.);
+    h->Fill(2., 0.5);
+
+    RT::HistPyramid pyramid(h, 10);
+    ASSERT_EQ(pyramid.getLevels(), 5);
+    ASSERT_EQ(pyramid.getLevel(0), h);
+    ASSERT_EQ(pyramid.getLevel(4)->GetNbinsX(), 7);
+
+    double err_ref = 0.0;
+    for (int b = 0; b < h->GetNcells(); ++b)
+        err_ref += h->GetBinError(b) * h->GetBinError(b);
+
+    for (size_t l = 1; l < pyramid.getLevels(); ++l)
+    {
+        TH2* lvl = pyramid.getLevel(l);
+        ASSERT_DOUBLE_EQ(lvl->Integral(0, -1, 0, -1), h->Integral(0, -1, 0, -1));
+
+        double err = 0.0;
+        for (int b = 0; b < lvl->GetNcells(); ++b)
+            err += lvl->GetBinError(b) * lvl->GetBinError(b);
+        ASSERT_DOUBLE_EQ(err, err_ref);
+    }
+
+    ASSERT_EQ(pyramid.selectLevel(30, 30)->GetNbinsX(), 50);
+    ASSERT_EQ(pyramid.selectLevel(5, 5)->GetNbinsX(), 7);
+    ASSERT_EQ(pyramid.selectLevel(500, 500), h);
+};
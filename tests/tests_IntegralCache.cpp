@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <IntegralCache.h>
+
+#include <TF1.h>
+#include <TStopwatch.h>
+
+TEST(tests_IntegralCache, integral_test)
+{
+    TF1* f = new TF1("f_intcache", "gaus(0)+pol1(3)", 0, 10);
+    f->SetParameters(std::vector<Double_t>({100, 5, 0.5, 10, -0.5}).data());
+
+    RT::IntegralCache cache(f);
+    ASSERT_NEAR(cache.integral(2, 8), f->Integral(2, 8), 1e-8 * f->Integral(2, 8));
+    ASSERT_NEAR(cache.integral(4.123, 5.456), f->Integral(4.123, 5.456), 1e-6);
+    ASSERT_EQ(cache.integral(3, 3), 0);
+    ASSERT_EQ(cache.getBuilds(), 1);
+
+    f->SetParameter(2, 0.3);
+    ASSERT_NEAR(cache.integral(2, 8), f->Integral(2, 8), 1e-8 * f->Integral(2, 8));
+    ASSERT_EQ(cache.getBuilds(), 2);
+
+    // outside of the range
+    ASSERT_DOUBLE_EQ(cache.integral(-1, 2), f->Integral(-1, 2));
+    ASSERT_EQ(cache.getBuilds(), 2);
+
+    delete f;
+};
+
+TEST(tests_IntegralCache, benchmark_test)
+{
+    TF1* f = new TF1("f_intcache_bench", "gaus(0)+expo(3)", 0, 10);
+    f->SetParameters(std::vector<Double_t>({100, 5, 0.3, 3, -0.3}).data());
+
+    const int n = 2000;
+    std::vector<Double_t> ls(n), us(n), ref(n), res(n);
+    for (int i = 0; i < n; ++i)
+    {
+        ls[i] = 10.0 * i / n * 0.5;
+        us[i] = ls[i] + 0.5 + 4.0 * (i % 17) / 17;
+    }
+
+    TStopwatch sw;
+    sw.Start();
+    for (int i = 0; i < n; ++i)
+        ref[i] = f->Integral(ls[i], us[i]);
+    sw.Stop();
+    double t_ref = sw.RealTime();
+
+    for (Int_t npoints : {100, 1000, 10000})
+    {
+        RT::IntegralCache cache(f, npoints);
+
+        sw.Start();
+        for (int i = 0; i < n; ++i)
+            res[i] = cache.integral(ls[i], us[i]);
+        sw.Stop();
+
+        double max_rel = 0.0;
+        for (int i = 0; i < n; ++i)
+            max_rel = std::max(max_rel, fabs(res[i] - ref[i]) / fabs(ref[i]));
+
+        printf("npoints=%5d  TF1::Integral %.3g s  cached %.3g s (incl. build)  max rel. error "
+               "%.2g\n",
+               npoints, t_ref, sw.RealTime(), max_rel);
+
+        if (npoints >= 1000) { ASSERT_LT(max_rel, 1e-7); }
+    }
+
+    delete f;
+};
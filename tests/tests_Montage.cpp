@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include <Montage.h>
+
+#include <TCanvas.h>
+#include <TH1.h>
+#include <TROOT.h>
+#include <TSystem.h>
+
+TEST(tests_Montage, atlas_test)
+{
+    gROOT->SetBatch(kTRUE);
+
+    std::vector<TCanvas*> canvases;
+    for (int i = 0; i < 5; ++i)
+    {
+        TCanvas* can = new TCanvas(TString::Format("c_montage_%d", i), "c", 400, 300);
+        TH1D* h = new TH1D(TString::Format("h_montage_%d", i), "h", 10, 0, 10);
+        h->Fill(i);
+        h->Draw();
+        canvases.push_back(can);
+    }
+
+    TString fname = TString(gSystem->TempDirectory()) + "/tests_Montage.png";
+
+    ASSERT_EQ(RT::Exports::ExportMontage(canvases, fname, 3, 600, 300, 2), 0);
+    ASSERT_FALSE(gSystem->AccessPathName(fname));
+
+    ASSERT_EQ(RT::Exports::ExportMontage(canvases, fname, 0, 600, 300), -1);
+
+    for (auto c : canvases)
+        delete c;
+};
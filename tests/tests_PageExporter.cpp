@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <PageExporter.h>
+
+#include <TCanvas.h>
+#include <TH1.h>
+#include <TROOT.h>
+#include <TSystem.h>
+
+#include <fstream>
+#include <string>
+
+TEST(tests_PageExporter, pages_test)
+{
+    gROOT->SetBatch(kTRUE);
+
+    TString path = TString(gSystem->TempDirectory()) + "/";
+
+    RT::Exports::PageExporter pdf(path + "tests_PageExporter.pdf");
+    ASSERT_TRUE(pdf.isOpen());
+
+    {
+        RT::Exports::PageExporter second(path + "tests_PageExporter_second.pdf");
+        ASSERT_FALSE(second.isOpen());
+    }
+
+    for (int i = 0; i < 3; ++i)
+    {
+        TCanvas* can = new TCanvas(TString::Format("c_pages_%d", i), "c", 200, 200);
+        TH1D* h = new TH1D(TString::Format("h_pages_%d", i), "h", 10, 0, 10);
+        h->Fill(i);
+        h->Draw();
+        pdf.addPage(can, TString::Format("Page %d", i));
+        delete can;
+    }
+
+    pdf.close();
+    ASSERT_FALSE(pdf.isOpen());
+    ASSERT_EQ(pdf.getPages(), 3);
+    ASSERT_FALSE(gSystem->AccessPathName(path + "tests_PageExporter.pdf"));
+
+    ASSERT_TRUE(pdf.writeIndex(path + "tests_PageExporter.toc"));
+
+    std::ifstream ifs((path + "tests_PageExporter.toc").Data());
+    std::string line;
+    int lines = 0;
+    while (std::getline(ifs, line))
+        ++lines;
+    ASSERT_EQ(lines, 4);
+
+    RT::Exports::PageExporter next(path + "tests_PageExporter_next.pdf");
+    ASSERT_TRUE(next.isOpen());
+};
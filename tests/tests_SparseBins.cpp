@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <RootTools.h>
+#include <SparseBins.h>
+
+#include <TH2.h>
+
+TEST(tests_SparseBins, build_test)
+{
+    TH2D* h = new TH2D("h_sparse", "h", 100, 0, 100, 100, 0, 100);
+    h->Sumw2();
+    h->Fill(10.5, 20.5, 2);
+    h->Fill(50.5, 70.5, 3);
+    h->Fill(-1, 5); // underflow is not listed
+
+    RT::SparseBins sb(h);
+    ASSERT_EQ(sb.size(), 2);
+    ASSERT_EQ(sb.getBins()[0], h->GetBin(11, 21));
+
+    sb.fillXY(h, 10.5, 20.5);
+    ASSERT_EQ(sb.size(), 2);
+    sb.fillXY(h, 90.5, 90.5);
+    ASSERT_EQ(sb.size(), 3);
+    sb.fillXY(h, 150, 5);
+    ASSERT_EQ(sb.size(), 3);
+
+    ASSERT_DOUBLE_EQ(RT::calcTotalContent(h, sb), RT::calcTotalContent(h));
+    ASSERT_DOUBLE_EQ(RT::calcTotalError(h, sb), RT::calcTotalError(h));
+
+    double c1, e1, c2, e2;
+    RT::calcTotalHistogramValues(h, c1, e1);
+    RT::calcTotalHistogramValues(h, sb, c2, e2);
+    ASSERT_DOUBLE_EQ(c1, c2);
+    ASSERT_DOUBLE_EQ(e1, e2);
+
+    TH2D* g = (TH2D*)h->Clone("h_sparse_dense");
+    RT::calcErrorPropagationMult(g, 2, 0.1);
+    RT::calcErrorPropagationMult(h, sb, 2, 0.1);
+    for (Int_t bin = 0; bin < h->GetNcells(); ++bin)
+        ASSERT_DOUBLE_EQ(h->GetBinError(bin), g->GetBinError(bin));
+
+    TH1* re = RT::makeRelativeErrorHistogram(h, sb);
+    ASSERT_DOUBLE_EQ(re->GetBinContent(51, 71), h->GetBinError(51, 71) / 3);
+    ASSERT_EQ(re->GetBinContent(1, 1), 0);
+
+    delete re;
+    delete g;
+    delete h;
+};
+
+TEST(tests_SparseBins, one_dim_test)
+{
+    TH1D* h = new TH1D("h_sparse_1d", "h", 1000, 0, 1000);
+    RT::SparseBins sb(h);
+    ASSERT_EQ(sb.size(), 0);
+
+    sb.fill(h, 3.5);
+    sb.fill(h, 700.5, 2);
+    ASSERT_EQ(sb.size(), 2);
+    ASSERT_DOUBLE_EQ(RT::calcTotalContent(h, sb), 3);
+
+    delete h;
+};
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include <Systematics.h>
+
+#include <TH1.h>
+
+TEST(tests_Systematics, combine_test)
+{
+    RT::SystematicsTable tab(2);
+    size_t a = tab.addSource("a");
+    size_t b = tab.addSource("b");
+    size_t c1 = tab.addSource("c1", 0);
+    size_t c2 = tab.addSource("c2", 0);
+
+    tab.setError(a, 0, 3, 1);
+    tab.setError(b, 0, 4, 1);
+    tab.setError(c1, 1, 1, 0);
+    tab.setError(c2, 1, 2, 0);
+
+    Double_t high[2], low[2];
+    tab.combine(high, low);
+    ASSERT_DOUBLE_EQ(high[0], 5);
+    ASSERT_DOUBLE_EQ(low[0], sqrt(2));
+    ASSERT_DOUBLE_EQ(high[1], 3);
+    ASSERT_DOUBLE_EQ(low[1], 0);
+
+    Double_t th, tl;
+    tab.total(th, tl);
+    ASSERT_DOUBLE_EQ(th, sqrt(9 + 16 + 9));
+    ASSERT_DOUBLE_EQ(tl, sqrt(2));
+
+    TH1D* h = new TH1D("h_syst", "h", 2, 0, 2);
+    RT::SystematicsTable htab(h);
+    ASSERT_EQ(htab.getBins(), 4);
+    size_t s = htab.addSource("s");
+    htab.setError(s, 1, 2, 1);
+    htab.apply(h, kFALSE);
+    ASSERT_DOUBLE_EQ(h->GetBinError(1), 2);
+    delete h;
+};
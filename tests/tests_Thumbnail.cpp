@@ -0,0 +1,26 @@
+#include <gtest/gtest.h>
+
+#include <Thumbnail.h>
+
+#include <TH1.h>
+#include <TH2.h>
+
+TEST(tests_Thumbnail, render_test)
+{
+    RT::NicePalette();
+    RT::Thumbnail thumb(100, 80);
+
+    TH1D* h1 = new TH1D("h_thumbnail_1d", "h", 10, 0, 10);
+    h1->FillRandom("pol0", 100);
+
+    auto pixels = thumb.render(h1);
+    ASSERT_EQ(pixels.size(), 100 * 80);
+
+    TH2D* h2 = new TH2D("h_thumbnail_2d", "h", 1, 0, 1, 1, 0, 1);
+    h2->Fill(0.5, 0.5);
+
+    pixels = thumb.render(h2);
+    ASSERT_EQ(pixels.size(), 100 * 80);
+    ASSERT_NE(pixels[40 * 100 + 50], 0xffffffff);
+    ASSERT_EQ(pixels[0], 0xffffffff);
+};
@@ -0,0 +1,35 @@
+#include <gtest/gtest.h>
+
+#include <RootTools.h>
+#include <Tokenizer.h>
+
+#include <string>
+#include <vector>
+
+static std::vector<std::string> Collect(const RT::Tokenizer& tok)
+{
+    std::vector<std::string> fields;
+    for (const RT::Tokenizer::Field& f : tok)
+        fields.push_back(f.str());
+    return fields;
+}
+
+TEST(tests_Tokenizer, policies_test)
+{
+    typedef std::vector<std::string> V;
+
+    ASSERT_EQ(Collect(RT::Tokenizer("a,,b,", ",")), V({"a", "", "b", ""}));
+    ASSERT_EQ(Collect(RT::Tokenizer("a,,b,", ",", RT::EF_SKIP)), V({"a", "b"}));
+    ASSERT_EQ(Collect(RT::Tokenizer("a,,b,", ",", RT::EF_DROP_TRAILING)), V({"a", "", "b"}));
+    ASSERT_EQ(Collect(RT::Tokenizer("a b;c", " ;")), V({"a", "b", "c"}));
+    ASSERT_EQ(Collect(RT::Tokenizer("", ",")), V({""}));
+    ASSERT_EQ(Collect(RT::Tokenizer("", ",", RT::EF_DROP_TRAILING)), V());
+    ASSERT_EQ(Collect(RT::Tokenizer(",,", ",", RT::EF_SKIP)), V());
+
+    std::string line = "x|y|z";
+    ASSERT_EQ(Collect(RT::Tokenizer(line.data(), 3, "|", 1)), V({"x", "y"}));
+    ASSERT_EQ(Collect(RT::Tokenizer(line, "|", RT::EF_SKIP)), V({"x", "y", "z"}));
+
+    ASSERT_EQ(RT::split(",a,,b,", ','), V({"", "a", "", "b"}));
+    ASSERT_EQ(RT::split("", ','), V());
+};
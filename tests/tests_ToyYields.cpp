@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <ToyYields.h>
+
+#include <TF1.h>
+#include <TH1.h>
+
+#include <cmath>
+
+TEST(tests_ToyYields, reproducibility_test)
+{
+    TH1D* h = new TH1D("h_toys", "h", 60, 0, 6);
+    TF1* model = new TF1("f_toys_model", "gaus(0)+pol0(3)", 0, 6);
+    model->SetParameters(std::vector<Double_t>({200, 3, 0.3, 20}).data());
+    for (Int_t b = 1; b <= 60; ++b)
+        h->SetBinContent(b, model->Eval(h->GetBinCenter(b)));
+
+    TF1* total = new TF1("f_toys_total", "gaus(0)+pol0(3)", 0, 6);
+    total->SetParameters(model->GetParameters());
+    TF1* bkg = new TF1("f_toys_bkg", "pol0", 0, 6);
+
+    RT::ToyYields toys1(h, total, bkg, 1);
+    toys1.setRange(2, 4);
+    RT::ToyResult r1 = toys1.run(20);
+
+    RT::ToyYields toys4(h, total, bkg, 4);
+    toys4.setRange(2, 4);
+    RT::ToyResult r4 = toys4.run(20);
+
+    ASSERT_EQ(r1.yields.size(), 20);
+    ASSERT_EQ(r1.failed, r4.failed);
+    for (size_t i = 0; i < r1.yields.size(); ++i)
+    {
+        if (std::isnan(r1.yields[i]))
+            ASSERT_TRUE(std::isnan(r4.yields[i]));
+        else
+            ASSERT_DOUBLE_EQ(r1.yields[i], r4.yields[i]);
+    }
+
+    // integral of the gaussian
+    double yield = 200 * sqrt(2 * M_PI) * 0.3;
+    ASSERT_NEAR(r1.mean(), yield, 5 * r1.rms());
+    ASSERT_LE(r1.quantile(0.16), r1.quantile(0.84));
+
+    toys1.setMode(RT::TM_BOOTSTRAP);
+    RT::ToyResult rb = toys1.run(10);
+    ASSERT_LT(rb.failed, 10);
+
+    TH1* dist = r1.makeHistogram("h_toys_yields", 20);
+    ASSERT_EQ(dist->GetEntries(), 20 - r1.failed);
+    delete dist;
+
+    delete bkg;
+    delete total;
+    delete model;
+    delete h;
+};